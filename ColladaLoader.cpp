@@ -1,499 +1,1135 @@
 #include <ColladaLoader.h>
 
-ColladaLoader::
-ColladaLoader(){
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <thread>
 
-  indexNum = 0;
-  numOfInput = 0;
-  
-}
+namespace {
 
-void
-ColladaLoader::
-parseSpecNode(XMLNode& _node){
+  const char*
+  parseTokens(const char* _begin, const char* _end, float* _out,
+              size_t _capacity, size_t& _count){
 
-    glm::vec4 vecToAdd;
-    float floatToAdd;
+    return parseFloatArray(_begin, _end, _out, _capacity, _count);
 
-    XMLNode infoNode(_node.getFirstChild());
+  }
 
-    if(infoNode.name() != "texture"){
-      
-      string nodeContent = infoNode.getString();
+  const char*
+  parseTokens(const char* _begin, const char* _end, ColladaLoader::Index* _out,
+              size_t _capacity, size_t& _count){
 
-      string specName = _node.name();
-        
-      // tokenizing the string
-      istringstream iss(nodeContent);
+    return parseIndexArray(_begin, _end, _out, _capacity, _count);
 
-      vector<float> tokens;
+  }
 
-      copy(istream_iterator<float>(iss),
-        istream_iterator<float>(),
-        back_inserter(tokens));
+  const char*
+  parseTokens(const char* _begin, const char* _end, NumberVector<float>& _out,
+              unsigned _threads){
 
-      if(specName == "shininess" || specName == "reflectivity" || specName == "transparency" ){
+    return parseFloatArray(_begin, _end, _out, _threads);
 
-        floatToAdd = tokens[0];
+  }
 
-      } else{
+  const char*
+  parseTokens(const char* _begin, const char* _end,
+              NumberVector<ColladaLoader::Index>& _out, unsigned _threads){
 
-        vecToAdd[0] = tokens[0];
-        vecToAdd[1] = tokens[1];
-        vecToAdd[2] = tokens[2];
-        vecToAdd[3] = tokens[3];
+    return parseIndexArray(_begin, _end, _out, _threads);
 
-      }
-          
-      if(specName == "shininess"){
+  }
 
-        material.shininess = floatToAdd;
+  // seperating each space delimitered string, converting
+  // them into floats or indices. works on the text in place;
+  // like reading with an istream, stops at the first token
+  // that isn't a number
+  template<typename T>
+  void
+  tokenize(const char* _begin, const char* _end, NumberVector<T>& _tokens,
+           unsigned _threads = 1){
 
-      } else if(specName == "reflectivity"){
+    // long arrays are split between threads, each converting
+    // its piece straight into place
+    if(_threads > 1){
 
-        material.reflectivity = floatToAdd;
+      parseTokens(_begin, _end, _tokens, _threads);
+      return;
 
-      } else if(specName == "transparency"){
+    }
 
-        material.transparency = floatToAdd;
+    // the values are written straight into the vector: into
+    // the room reserved for them first, then a chunk at a
+    // time. no more than one value every two characters, so
+    // short text doesn't get a whole chunk. the room is left
+    // uninitialized, so each value is written once
+    const size_t chunk = min<size_t>(4096, (_end - _begin + 1) / 2);
 
-      } else if(specName == "index_of_refraction"){
+    while(true){
 
-        material.refractionIndex = floatToAdd;
+      size_t size = _tokens.size();
+      size_t room = max(_tokens.capacity() - size, chunk);
+      _tokens.resize(size + room);
 
-      }
+      size_t count;
+      _begin = parseTokens(_begin, _end, _tokens.data() + size, room, count);
 
-      if(specName == "emission"){
+      _tokens.resize(size + count);
 
-        material.emission = vecToAdd;
+      // stopped early, or nothing left to convert
+      if(count < room || _begin == _end)
+        return;
 
-      } else if(specName == "ambient"){
+    }
 
-        material.ambient = vecToAdd;
+  }
 
-      } else if(specName == "diffuse"){
+  // make room for the values an array element declares up
+  // front, so it is filled without reallocating. a count
+  // can't be trusted before it is checked, so never more
+  // than the _length characters of text left could hold
+  template<typename T>
+  void
+  reserveDeclared(NumberVector<T>& _tokens, long long _declared, size_t _length){
 
-        material.diffuse = vecToAdd;
+    if(_declared > 0)
+      _tokens.reserve(min<size_t>(_declared,
+                                  _tokens.size() + (_length + 1) / 2));
 
-      } else if(specName == "specular"){
+  }
 
-        material.specular = vecToAdd;
+  // the size an array element declares must be the size it
+  // has; _declared is negative when it declares none
+  void
+  checkDeclared(const string& _where, const string& _array,
+                long long _declared, size_t _parsed){
 
-      } else if(specName == "reflective"){
+    if(_declared >= 0 && size_t(_declared) != _parsed)
+      throw ParseException(_where, "<" + _array + "> declares " +
+          to_string(_declared) + " values but holds " +
+          to_string(_parsed) + ".");
 
-        material.reflective = vecToAdd;
+  }
 
-      } else if(specName == "transparent"){
+  // an accessor may only read what its array holds
+  void
+  checkAccessor(const string& _where, int _stride, int _count, size_t _parsed){
 
-        material.transparent = vecToAdd;  
+    if(size_t(_stride) * size_t(_count) > _parsed)
+      throw ParseException(_where, "<accessor> reads " +
+          to_string(size_t(_stride) * size_t(_count)) +
+          " values from an array of " + to_string(_parsed) + ".");
 
-      }
-    
   }
-}
 
-void 
-ColladaLoader::
-parseMaterials(XMLNode& _node){
+  // the number of indices in the <p> of a <polylist> or
+  // <triangles>: one per input offset for each vertex of each
+  // face. negative when the faces don't say how many vertices
+  // they have
+  long long
+  declaredIndices(ColladaTag _tag, long long _count,
+                  const NumberVector<ColladaLoader::Index>* _vcount,
+                  long long _offsets){
 
-  XMLNode* effectNode = nullptr;
-  XMLNode* profileCommonNode = nullptr;
-  XMLNode* techniqueNode = nullptr;
-  XMLNode* specNode = nullptr;
+    long long vertices = -1;
 
-  // reaching the effects node
-  for (auto& child : _node){
+    if(_tag == ColladaTag::Triangles && _count >= 0)
+      vertices = _count * 3;
+    else if(_vcount)
+      vertices = accumulate(_vcount->begin(), _vcount->end(), 0ll);
 
-    if(child.name() == "effect"){
+    return vertices < 0 ? -1 : vertices * _offsets;
 
-      effectNode = &child;
-      break;
+  }
 
-    }
+  // the position, normal and texture coordinate index of a
+  // corner of a face
+  typedef glm::vec<3, ColladaLoader::Index> Corner;
 
-  }
+  uint64_t
+  hashCorner(const Corner& _corner){
 
-  // reaching the profileCommonNode
-  for (auto& child : *effectNode){
+    uint64_t hash = (_corner.x + 1) * 0x9e3779b97f4a7c15ull;
+    hash = (hash ^ (hash >> 29) ^ _corner.y) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 32) ^ _corner.z) * 0x94d049bb133111ebull;
 
-    if(child.name() == "profile_COMMON"){
+    return hash ^ (hash >> 31);
 
-      profileCommonNode = &child;
-      break;
+  }
 
-    }
+  // the shard of a corner's hash. the low bits pick the slot
+  // in the shard's table, the high ones the shard
+  unsigned
+  cornerShard(uint64_t _hash, unsigned _shards){
+
+    return (_hash >> 40) % _shards;
 
   }
 
-  // reaching the techniqueNode
-   for (auto& child : *profileCommonNode){
+  // sets _first[c] to the first corner equal to corner c, for
+  // the corners numbered in _shard, in increasing order; all of
+  // them when _shard is null. every shard has its own table, so
+  // shards can run side by side and still agree with a single
+  // one
+  void
+  findFirstCorners(const vector<Corner>& _corners,
+                   const vector<uint32_t>* _shard,
+                   vector<uint32_t>& _first){
 
-    if(child.name() == "technique"){
+    const uint32_t empty = UINT32_MAX;
 
-      techniqueNode = &child;
-      break;
+    size_t count = _shard ? _shard->size() : _corners.size();
+
+    // open addressing on the corner numbers, kept at most half
+    // full. big enough for every corner of the shard to be
+    // distinct
+    size_t size = 16;
+    while(size < count * 2)
+      size *= 2;
+
+    vector<uint32_t> slots(size, empty);
+
+    for(size_t k=0; k<count; k++){
+
+      size_t c = _shard ? (*_shard)[k] : k;
+
+      size_t slot = hashCorner(_corners[c]) & (size - 1);
+
+      while(slots[slot] != empty && _corners[slots[slot]] != _corners[c])
+        slot = (slot + 1) & (size - 1);
+
+      if(slots[slot] != empty){
+
+        _first[c] = slots[slot];
+        continue;
+
+      }
+
+      slots[slot] = uint32_t(c);
+      _first[c] = uint32_t(c);
 
     }
 
   }
 
+  // nearest half float, ties to even. overflow becomes
+  // infinity, as with the conversion instructions
+  uint16_t
+  toHalf(float _value){
 
-  // reaching the specNode
-   for (auto& child : *techniqueNode){
+    uint32_t bits;
+    memcpy(&bits, &_value, sizeof(bits));
 
-    if(child.name() == "phong" || child.name() == "blinn" || child.name() == "lambert"){
+    uint16_t sign = (bits >> 16) & 0x8000;
+    uint32_t magnitude = bits & 0x7fffffff;
 
-      specNode = &child;
-      break;
+    // nan, kept quiet
+    if(magnitude > 0x7f800000)
+      return sign | 0x7e00;
+
+    // 65520 and up round to infinity
+    if(magnitude >= 0x477ff000)
+      return sign | 0x7c00;
+
+    uint32_t half, rest, halfway;
+
+    if(magnitude >= 0x38800000){
+
+      // normal: rebiasing the exponent, dropping 13 bits
+      half = (magnitude - 0x38000000) >> 13;
+      rest = magnitude & 0x1fff;
+      halfway = 0x1000;
+
+    } else if(magnitude > 0x33000000){
+
+      // subnormal: the implicit bit made explicit, shifted into
+      // units of 2^-24
+      uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+      int shift = 126 - int(magnitude >> 23);
+
+      half = mantissa >> shift;
+      rest = mantissa & ((1u << shift) - 1);
+      halfway = 1u << (shift - 1);
+
+    } else{
+
+      // at most half the smallest subnormal
+      return sign;
 
     }
 
+    // a carry out of the mantissa steps the exponent, as it should
+    if(rest > halfway || (rest == halfway && (half & 1)))
+      half++;
+
+    return sign | uint16_t(half);
+
   }
 
-  // since there are more than one property stored
-  for (auto& child : *specNode){
+  // _value clamped to [_low, 1], nan to 0, scaled by _scale and
+  // rounded
+  long
+  toNormalized(float _value, float _low, float _scale){
 
-      parseSpecNode(child);
+    if(_value > 1)
+      _value = 1;
+    else if(_value < _low)
+      _value = _low;
+    else if(_value != _value)
+      _value = 0;
 
-      // add to the material vector
-      materialVector.push_back(material);  
+    return lround(_value * _scale);
 
   }
 
+  // writes _count components of _values as T, each through
+  // _convert, to wherever _out points
+  template<typename T, typename F>
+  void
+  writeComponents(unsigned char* _out, const float* _values, int _count,
+                  F _convert){
 
-}
-
-void
-ColladaLoader::
-fillPolylistVector(){
+    for(int i=0; i<_count; i++){
 
-  for(int i=0; i<faceVector.size(); i++){ // amount of polylists
+      T component = T(_convert(_values[i]));
+      memcpy(_out + i * sizeof(T), &component, sizeof(T));
 
-    Polylist polylistVectorToAdd;
+    }
 
-    for(int j=0; j< faceVector[i].size(); j++){ // filling the polylist
+  }
 
-      Vertex vertexToAdd;
+  // writes the _components values of an attribute in _format
+  void
+  writeAttribute(unsigned char* _out,
+                 ColladaLoader::VertexAttribute::Format _format,
+                 const glm::vec3& _value, int _components){
 
-      // filling in the vertices
-      vertexToAdd.position = arrayVector[0][faceVector[i][j].x];
-      vertexToAdd.normal = arrayVector[1][faceVector[i][j].y];
-      vertexToAdd.texture = arrayVector[2][faceVector[i][j].z];
+    typedef ColladaLoader::VertexAttribute Attribute;
 
-      // adding vertices to a polylist
-      polylistVectorToAdd.vertexCollection.push_back(vertexToAdd);
+    float values[4] = {0, 0, 0, 0};
 
-    } // a polylist is now filled with vertices
+    for(int i=0; i<_components; i++)
+      values[i] = _value[i];
 
-    // add the filled polylist to the list of polylists
-    polylistVector.push_back(polylistVectorToAdd);
+    auto asFloat = [](float _v){ return _v; };
+    auto asSnorm16 = [](float _v){ return toNormalized(_v, -1, 32767); };
+    auto asUnorm16 = [](float _v){ return toNormalized(_v, 0, 65535); };
+    auto asSnorm8 = [](float _v){ return toNormalized(_v, -1, 127); };
+    auto asUnorm8 = [](float _v){ return toNormalized(_v, 0, 255); };
 
-    // clearing the vertex collection
-    polylistVectorToAdd.vertexCollection.clear();
+    switch(_format){
 
-  }
+      case Attribute::Float2:
+        writeComponents<float>(_out, values, 2, asFloat);
+        break;
 
-}
+      case Attribute::Float3:
+        writeComponents<float>(_out, values, 3, asFloat);
+        break;
 
-void
-ColladaLoader::
-parsePolylistNode(XMLNode& _node){
+      case Attribute::Float4:
+        writeComponents<float>(_out, values, 4, asFloat);
+        break;
 
-  vector<glm::vec3> vectors;
+      case Attribute::Half2:
+        writeComponents<uint16_t>(_out, values, 2, toHalf);
+        break;
 
-  // vector<string> idVector;
+      case Attribute::Half4:
+        writeComponents<uint16_t>(_out, values, 4, toHalf);
+        break;
 
-  XMLNode* pNode = nullptr;
-  XMLNode* vcount = nullptr;
-  XMLNode* inputNode = nullptr; 
+      case Attribute::Snorm16x2:
+        writeComponents<int16_t>(_out, values, 2, asSnorm16);
+        break;
 
-  for (auto& child : _node) {
+      case Attribute::Snorm16x4:
+        writeComponents<int16_t>(_out, values, 4, asSnorm16);
+        break;
 
-    // reaching the input node
-    if(child.name() == "input"){
+      case Attribute::Unorm16x2:
+        writeComponents<uint16_t>(_out, values, 2, asUnorm16);
+        break;
 
-      // idVector.push_back( child.read("source", true, "", "SOURCE"));
+      case Attribute::Snorm8x4:
+        writeComponents<int8_t>(_out, values, 4, asSnorm8);
+        break;
 
-      // incrementing this allows us to see how many parameters per vertex
-      numOfInput++;
+      case Attribute::Unorm8x4:
+        writeComponents<uint8_t>(_out, values, 4, asUnorm8);
+        break;
 
     }
 
   }
 
-  // reaching the input node
-  for (auto& child : _node) {
+  glm::vec4
+  toColor(const NumberVector<float>& _tokens){
 
-    if(child.name() == "input"){
+    return glm::vec4(_tokens[0], _tokens[1], _tokens[2], _tokens[3]);
 
-      inputNode = &child;
-      break;
+  }
 
-    }
+  // the interner handed to the XML parser, so that every
+  // element carries its ColladaTag
+  int
+  internTag(const char* _name, size_t _length){
+
+    return int(colladaTag(_name, _length));
 
   }
 
-  // reaching p node
-  for (auto& child : _node) {
+  // the shading models of profile_COMMON
+  bool
+  isShading(ColladaTag _tag){
 
-     if (child.name() == "p"){
+    return _tag == ColladaTag::Phong || _tag == ColladaTag::Blinn ||
+           _tag == ColladaTag::Lambert;
 
-      pNode = &child;
-      break;
+  }
 
-    }
+  ColladaTag
+  tagOf(const XMLNode& _node){
+
+    int id = _node.nameId();
+
+    // nodes parsed without the interner are looked up here
+    return id >= 0 ? ColladaTag(id) : colladaTag(_node.name());
 
   }
- 
-  // reaching vcount node
-  for (auto& child : _node) {
 
-    if (child.name() == "vcount"){
+  // whether a top-level element is left out, given the
+  // libraries asked for in LoadOptions
+  bool
+  isSkipped(ColladaTag _tag, unsigned _libraries){
 
-      vcount = &child;
-      break;
+    switch(_tag){
+
+      case ColladaTag::LibraryGeometries:
+        return !(_libraries & ColladaLoader::LoadOptions::Geometries);
+
+      case ColladaTag::LibraryEffects:
+        return !(_libraries & ColladaLoader::LoadOptions::Effects);
+
+      default:
+        return true;
 
     }
 
   }
 
-  // turning the entire concent into a big string
-  string nodeContent = pNode->getString();
+  // skip filter handed to the XML parser, so that unwanted
+  // libraries never become nodes
+  class LibraryFilter : public TiXmlSkipFilter {
 
-  // tokenizing the string
-  istringstream iss(nodeContent);
+    public:
 
-  vector<float> tokens;
+      LibraryFilter(unsigned _libraries) : m_libraries(_libraries) {}
 
-  // seperating each space delimitered string, converting
-  // them into floats
-  copy( istream_iterator<float>(iss),
-        istream_iterator<float>(),
-         back_inserter(tokens)  );
+      bool Skip(const char* _name, size_t _length, int _depth) override {
 
-  // adding vectors of float to the position vectors
-  glm::vec3 verticesToBeAdded;
- 
-    for(int i=0; i<tokens.size(); i++){
+        return _depth == 1 && isSkipped(colladaTag(_name, _length), m_libraries);
 
-      if(i % numOfInput == 0){
+      }
 
-        verticesToBeAdded.x = (tokens[i]);
+    private:
 
-      } else if(i % numOfInput == 1){
+      unsigned m_libraries;
 
-        verticesToBeAdded.y = (tokens[i]);
+  };
 
-      } else if(i % numOfInput == numOfInput-1){
+  // the first child with the given tag, or _node.end()
+  XMLNode::iterator
+  findChild(XMLNode& _node, ColladaTag _tag){
 
-        verticesToBeAdded.z = (tokens[i]);
-        
-      }
+    XMLNode::iterator child = _node.begin();
 
-      // faceVectorsToBeAdded.id += idVector[ i % numOfInput] + " ";
+    while(child != _node.end() && tagOf(*child) != _tag)
+      ++child;
 
-      // when at the end of a block, push it 
-      // to the vectors 
-      if (i % numOfInput == numOfInput-1){
+    return child;
 
-        vectors.push_back(verticesToBeAdded);
-        
-        // faceVectorsToBeAdded.id = "";
+  }
 
-      }
-     
-    }
+}
 
-    faceVector.push_back(vectors); // adds face vectors to the collection
+ColladaLoader::
+ColladaLoader(){
 
+  indexNum = 0;
+  numOfInput = 0;
+  
 }
 
 void
 ColladaLoader::
-parseSourceNode(XMLNode& _node){
+parseSpecNode(XMLNode& _node){
 
-  vector<glm::vec3> vectors;
+    XMLNode infoNode(_node.getFirstChild());
 
-  // reaching the child node with the relevant info
-  XMLNode arrayNode(_node.getFirstChild());
+    if(tagOf(infoNode) != ColladaTag::Texture){
+      
+      XMLTextView nodeContent = infoNode.getText();
 
-  // turning the entire concent into a big string
-  string nodeContent = arrayNode.getString();
+      // tokenizing the string
+      NumberVector<float> tokens;
 
-  // // reading the id of the child node
-  // string id = arrayNode.read("id", true, "", "ID");
+      tokenize(nodeContent.begin(), nodeContent.end(), tokens);
+
+      applySpec(tagOf(_node), tokens);
+    
+  }
+}
 
-  // tokenizing the string
-  istringstream iss(nodeContent);
+void
+ColladaLoader::
+applySpec(ColladaTag _spec, const NumberVector<float>& _tokens){
 
-  vector<float> tokens;
+  switch(_spec){
 
-  // seperating each space delimitered string, converting
-  // them into floats
-  copy( istream_iterator<float>(iss),
-        istream_iterator<float>(),
-        back_inserter(tokens) );
+    // single float properties
+    case ColladaTag::Shininess:
+      material.shininess = _tokens[0];
+      break;
 
-  // tokens.id = arrayNode.read("id", true, "", "ID");
+    case ColladaTag::Reflectivity:
+      material.reflectivity = _tokens[0];
+      break;
 
-  XMLNode* techCommonNode = nullptr;
-  XMLNode* accessorNode = nullptr;
+    case ColladaTag::Transparency:
+      material.transparency = _tokens[0];
+      break;
 
-  // reaching the technique_common node
-  for (auto& child : _node) {
+    case ColladaTag::IndexOfRefraction:
+      material.refractionIndex = _tokens[0];
+      break;
 
-    if (child.name() == "technique_common"){
+    // RGBA properties
+    case ColladaTag::Emission:
+      material.emission = toColor(_tokens);
+      break;
 
-       techCommonNode = &child;
-       break;
+    case ColladaTag::Ambient:
+      material.ambient = toColor(_tokens);
+      break;
 
-    }
-     
-  }
+    case ColladaTag::Diffuse:
+      material.diffuse = toColor(_tokens);
+      break;
 
-  // reaching the accessor node
-   for (auto& child : *techCommonNode) {
+    case ColladaTag::Specular:
+      material.specular = toColor(_tokens);
+      break;
 
-    if (child.name() == "accessor"){
+    case ColladaTag::Reflective:
+      material.reflective = toColor(_tokens);
+      break;
 
-       accessorNode = &child;
-       break;
+    case ColladaTag::Transparent:
+      material.transparent = toColor(_tokens);
+      break;
+
+    default:
+      break;
 
-    }
- 
   }
 
-  // reading accessor node attributes
-  int stride = stoi(accessorNode->read("stride", true, "", "Stride"));
-  int count = stoi(accessorNode->read("count", true, "", "Count"));
+}
 
-  // adding vectors of float to the position vectors
-  glm::vec3 vectorsToBeAdded;
- 
-    for(int i=0; i<count*stride; i++){
+void 
+ColladaLoader::
+parseMaterials(XMLNode& _node){
 
-      // if stride is 3, group things in 3s
-      // if stride is 2, group things in 2s
-      if(stride == 3){
+  // reaching the effects node
+  XMLNode::iterator effectNode = findChild(_node, ColladaTag::Effect);
+
+  // reaching the profileCommonNode
+  XMLNode::iterator profileCommonNode = findChild(*effectNode, ColladaTag::ProfileCOMMON);
 
-          if(i % stride == 0) {
+  // reaching the techniqueNode
+  XMLNode::iterator techniqueNode = findChild(*profileCommonNode, ColladaTag::Technique);
 
-          vectorsToBeAdded.x = (tokens[i]);
+  // reaching the specNode
+  XMLNode::iterator specNode = techniqueNode->begin();
 
-          } else if(i % stride == 1){
+  while(specNode != techniqueNode->end() && !isShading(tagOf(*specNode)))
+    ++specNode;
 
-          vectorsToBeAdded.y = (tokens[i]);
+  // since there are more than one property stored
+  for (auto& child : *specNode){
 
-          } else if(i % stride == stride-1){
+      parseSpecNode(child);
 
-          vectorsToBeAdded.z = (tokens[i]);
+      // add to the material vector
+      materialVector.push_back(material);  
 
-          }
+  }
 
-        // vectorsToBeAdded.id = tokens.id;
 
-        // when at the end of a block, push it 
-        // to the vectors 
-        if (i % stride == stride-1){
+}
 
-          vectors.push_back(vectorsToBeAdded);
+void
+ColladaLoader::
+fillPolylistVector(){
 
-        }
-     
-      } else if(stride == 2){
+  polylistVector.reserve(polylistVector.size() + faceVector.size());
 
-        if(i % stride == 0){
-          
-        vectorsToBeAdded.x = (tokens[i]);
+  for(size_t i=0; i<faceVector.size(); i++){ // amount of polylists
 
-        } else if(i % stride == 1){
+    Polylist polylistVectorToAdd;
 
-        vectorsToBeAdded.y = (tokens[i]);
-        
-        }
+    if(m_indexed){
 
-        // vectorsToBeAdded.id = tokens.id;
+      indexPolylist(faceVector[i], polylistVectorToAdd);
 
-        if (i % stride == stride-1){
+    } else{
 
-          vectors.push_back(vectorsToBeAdded);
+      reserveVertices(polylistVectorToAdd, faceVector[i].size());
 
-        }
+      for(size_t j=0; j< faceVector[i].size(); j++){ // filling the polylist
 
-      }
+        // adding vertices to a polylist
+        addVertex(polylistVectorToAdd, faceVector[i][j]);
+
+      } // a polylist is now filled with vertices
 
     }
 
-  arrayVector.push_back(vectors);
+    // add the filled polylist to the list of polylists
+    polylistVector.push_back(move(polylistVectorToAdd));
+
+    // its indices aren't needed anymore; freeing them as we go
+    // keeps them from adding up with the vertices
+    vector< glm::vec<3, Index> >().swap(faceVector[i]);
+
+  }
 
 }
 
-/*
-  void
-  ColladaLoader::
-  parseArrayIDs(XMLNode& _node){
+size_t
+ColladaLoader::VertexAttribute::
+size() const{
 
-    for (auto& child : _node) {
+  switch(format){
 
-      if(child.name() == "float_array"){
+    case Float2:
+      return 8;
 
-        idLookup.insert(   {child.read("id", true, "", "ID"), indexNum }   );
-        indexNum++;
+    case Float3:
+      return 12;
 
-      }
-      
-    }
-    
-  }
+    case Float4:
+      return 16;
 
-  // TODO
-  void
-  ColladaLoader::
-  parseSourceIDs(XMLNode& _node){}
+    case Half2:
+    case Unorm16x2:
+    case Snorm16x2:
+    case Snorm8x4:
+    case Unorm8x4:
+      return 4;
+
+    case Half4:
+    case Snorm16x4:
+      return 8;
 
+  }
 
+  return 0;
 
-*/
+}
 
 void
 ColladaLoader::
-parseGeometries(XMLNode& _node){
+setOutput(const LoadOptions& _options){
 
-  XMLNode* geoNode = nullptr;
-  XMLNode* meshNode = nullptr;
+  m_indexed = _options.indexed;
+  m_dedupThreadCorners = _options.dedupThreadCorners;
+  m_separateArrays = _options.separateArrays;
+  m_vertexLayout = _options.vertexLayout;
 
-  // there can be more than 2 source nodes! 
-  XMLNode* sourceNode = nullptr;
+  for(const VertexAttribute& attribute : m_vertexLayout.attributes){
 
-  // there can be more than 2 polylist nodes!
-  XMLNode* polylistNode = nullptr;
+    if(attribute.semantic < VertexAttribute::Position ||
+       attribute.semantic > VertexAttribute::Texture ||
+       attribute.size() == 0)
+      throw RunTimeException(WHERE, "Unknown vertex attribute or format.");
 
-  // reaching the geometry node
-  for (auto& child : _node) {
+    if(attribute.offset > m_vertexLayout.stride ||
+       attribute.size() > m_vertexLayout.stride - attribute.offset)
+      throw RunTimeException(WHERE, "Vertex attribute at offset " +
+          to_string(attribute.offset) + " doesn't fit a stride of " +
+          to_string(m_vertexLayout.stride) + " bytes.");
 
-    if (child.name() == "geometry"){
+  }
 
-      // geometry instance
-      Geometry geometryToAdd;
+}
 
-      geoNode = &child;
+void
+ColladaLoader::
+reserveVertices(Polylist& _polylist, size_t _count){
+
+  if(!m_vertexLayout.attributes.empty()){
+
+    _polylist.vertexBuffer.reserve(_count * m_vertexLayout.stride);
+    return;
+
+  }
+
+  if(!m_separateArrays){
+
+    _polylist.vertexCollection.reserve(_count);
+    return;
+
+  }
+
+  _polylist.vertexArrays.positions.reserve(_count);
+  _polylist.vertexArrays.normals.reserve(_count);
+  _polylist.vertexArrays.textures.reserve(_count);
+
+}
+
+void
+ColladaLoader::
+addVertex(Polylist& _polylist, const Corner& _corner){
+
+  if(!m_vertexLayout.attributes.empty()){
+
+    // written in place, over a zeroed vertex
+    AlignedVector<unsigned char>& buffer = _polylist.vertexBuffer;
+
+    size_t size = buffer.size();
+    buffer.resize(size + m_vertexLayout.stride);
+
+    for(const VertexAttribute& attribute : m_vertexLayout.attributes){
+
+      // semantics are numbered like the sources and the indices
+      // of a corner
+      int source = attribute.semantic;
+
+      writeAttribute(buffer.data() + size + attribute.offset, attribute.format,
+                     arrayVector[source][_corner[source]],
+                     source == VertexAttribute::Texture ? 2 : 3);
+
+    }
+
+    return;
+
+  }
+
+  if(m_separateArrays){
+
+    _polylist.vertexArrays.positions.push_back(arrayVector[0][_corner.x]);
+    _polylist.vertexArrays.normals.push_back(arrayVector[1][_corner.y]);
+    _polylist.vertexArrays.textures.push_back(arrayVector[2][_corner.z]);
+
+    return;
+
+  }
+
+  Vertex vertexToAdd;
+
+  // filling in the vertices
+  vertexToAdd.position = arrayVector[0][_corner.x];
+  vertexToAdd.normal = arrayVector[1][_corner.y];
+  vertexToAdd.texture = arrayVector[2][_corner.z];
+
+  _polylist.vertexCollection.push_back(vertexToAdd);
+
+}
+
+void
+ColladaLoader::
+indexPolylist(const vector<Corner>& _corners, Polylist& _polylist){
+
+  if(_corners.size() > UINT32_MAX)
+    throw RunTimeException(WHERE, "Too many corners for 32 bit indices.");
+
+  // the first corner equal to every corner, on a shard of the
+  // hash table per thread for large polylists
+  unsigned shards = 1;
+
+  if(m_arrayThreads > 1 && _corners.size() >= m_dedupThreadCorners){
+
+    shards = m_arrayThreads;
+    loadStats.parallelDedupCorners += _corners.size();
+
+  }
+
+  vector<uint32_t> first(_corners.size());
+
+  if(shards == 1){
+
+    findFirstCorners(_corners, nullptr, first);
+
+  } else{
+
+    // the corners of every shard, in one pass, so each thread
+    // only reads and hashes its own
+    vector< vector<uint32_t> > shardCorners(shards);
+
+    for(auto& corners : shardCorners)
+      corners.reserve(_corners.size() / shards + _corners.size() / shards / 8);
+
+    for(size_t c=0; c<_corners.size(); c++)
+      shardCorners[cornerShard(hashCorner(_corners[c]), shards)].push_back(uint32_t(c));
+
+    // shards that can't get a thread of their own run on this
+    // one
+    vector<thread> threads;
+    unsigned s = 1;
+
+    for(; s<shards; s++){
+
+      try{
+
+        threads.emplace_back([&, s]{ findFirstCorners(_corners, &shardCorners[s], first); });
+
+      } catch(...){
+
+        break;
+
+      }
+
+    }
+
+    for(; s<shards; s++)
+      findFirstCorners(_corners, &shardCorners[s], first);
+
+    findFirstCorners(_corners, &shardCorners[0], first);
+
+    for(auto& t : threads)
+      t.join();
+
+  }
+
+  // every distinct vertex is known now, so the output is sized once
+  size_t distinct = 0;
+
+  for(size_t c=0; c<_corners.size(); c++)
+    distinct += first[c] == c;
+
+  reserveVertices(_polylist, distinct);
+
+  // numbering the distinct vertices in the order they are first
+  // used, so the result is the same whatever the shards
+  _polylist.indices.resize(_corners.size());
+
+  uint32_t vertices = 0;
+
+  for(size_t c=0; c<_corners.size(); c++){
+
+    if(first[c] != c){
+
+      _polylist.indices[c] = _polylist.indices[first[c]];
+      continue;
+
+    }
+
+    _polylist.indices[c] = vertices++;
+
+    addVertex(_polylist, _corners[c]);
+
+  }
+
+}
+
+void
+ColladaLoader::
+parsePolylistNode(XMLNode& _node){
+
+  // vector<string> idVector;
+
+  // inputs can share an offset; the indices of a vertex are as
+  // many as the offsets
+  long long offsets = 0;
+
+  // the inputs of this polylist only
+  numOfInput = 0;
+
+  for (auto& child : _node) {
+
+    // reaching the input node
+    if(tagOf(child) == ColladaTag::Input){
+
+      // idVector.push_back( child.read("source", true, "", "SOURCE"));
+
+      // incrementing this allows us to see how many parameters per vertex
+      numOfInput++;
+
+      offsets = max(offsets,
+          child.readInt("offset", false, 0, 0, INT_MAX, "Offset") + 1ll);
+
+    }
+
+  }
+
+  // the vertex count of every face, for the size of <p>
+  NumberVector<Index> vcount;
+  XMLNode::iterator vcountNode = findChild(_node, ColladaTag::Vcount);
+
+  if(vcountNode != _node.end()){
+
+    XMLTextView vcountContent = vcountNode->getText();
+    tokenize(vcountContent.begin(), vcountContent.end(), vcount);
+
+  }
+
+  long long declared = declaredIndices(tagOf(_node),
+      _node.readInt("count", false, -1, 0, INT_MAX, "Count"),
+      vcountNode != _node.end() ? &vcount : nullptr, offsets);
+
+  // reaching p node
+  XMLNode::iterator pNode = findChild(_node, ColladaTag::P);
+
+  // the entire content, read in place
+  XMLTextView nodeContent = pNode->getText();
+
+  // tokenizing the string; indices stay integers all the way
+  NumberVector<Index> tokens;
+
+  reserveDeclared(tokens, declared, nodeContent.size);
+
+  tokenize(nodeContent.begin(), nodeContent.end(), tokens,
+           arrayThreads(nodeContent.size));
+
+  checkDeclared(pNode->where(), "p", declared, tokens.size());
+
+  buildFaceVectors(tokens, offsets);
+
+}
+
+void
+ColladaLoader::
+buildFaceVectors(const NumberVector<Index>& _tokens, long long _offsets){
+
+  vector< glm::vec<3, Index> > vectors;
+
+  // a polylist without inputs has no vertices
+  if(_offsets <= 0){
+
+    faceVector.push_back(move(vectors));
+    return;
+
+  }
+
+  vectors.reserve(_tokens.size() / _offsets);
+
+  // with fewer than three offsets the inputs share them: the normal
+  // reads the second offset, or the first if that is all there is, and
+  // the texture coordinate always reads the last
+  long long normalOffset = min(1ll, _offsets-1);
+
+  // adding vectors of indices to the face vectors
+  glm::vec<3, Index> verticesToBeAdded;
+ 
+    for(size_t i=0; i<_tokens.size(); i++){
+
+      long long offset = i % _offsets;
+
+      if(offset == 0){
+
+        verticesToBeAdded.x = (_tokens[i]);
+
+      }
+
+      if(offset == normalOffset){
+
+        verticesToBeAdded.y = (_tokens[i]);
+
+      }
+
+      if(offset == _offsets-1){
+
+        verticesToBeAdded.z = (_tokens[i]);
+        
+      }
+
+      // faceVectorsToBeAdded.id += idVector[ i % numOfInput] + " ";
+
+      // when at the end of a block, push it 
+      // to the vectors 
+      if (offset == _offsets-1){
+
+        vectors.push_back(verticesToBeAdded);
+        
+        // faceVectorsToBeAdded.id = "";
+
+      }
+     
+    }
+
+    faceVector.push_back(move(vectors)); // adds face vectors to the collection
+
+}
+
+void
+ColladaLoader::
+parseSourceNode(XMLNode& _node){
+
+  // reaching the child node with the relevant info
+  XMLNode arrayNode(_node.getFirstChild());
+
+  // the entire content, read in place
+  XMLTextView nodeContent = arrayNode.getText();
+
+  // // reading the id of the child node
+  // string id = arrayNode.read("id", true, "", "ID");
+
+  // tokenizing the string, into exactly the room the array
+  // says it needs
+  NumberVector<float> tokens;
+
+  int declared = arrayNode.readInt("count", false, -1, 0, INT_MAX, "Count");
+
+  reserveDeclared(tokens, declared, nodeContent.size);
+
+  tokenize(nodeContent.begin(), nodeContent.end(), tokens,
+           arrayThreads(nodeContent.size));
+
+  checkDeclared(arrayNode.where(), arrayNode.name(), declared, tokens.size());
+
+  // tokens.id = arrayNode.read("id", true, "", "ID");
+
+  // reaching the technique_common node
+  XMLNode::iterator techCommonNode = findChild(_node, ColladaTag::TechniqueCommon);
+
+  // reaching the accessor node
+  XMLNode::iterator accessorNode = findChild(*techCommonNode, ColladaTag::Accessor);
+
+  // reading accessor node attributes
+  int stride = accessorNode->readInt("stride", true, 0, 0, INT_MAX, "Stride");
+  int count = accessorNode->readInt("count", true, 0, 0, INT_MAX, "Count");
+
+  checkAccessor(accessorNode->where(), stride, count, tokens.size());
+
+  buildSourceVectors(tokens, stride, count);
+
+}
+
+void
+ColladaLoader::
+buildSourceVectors(const NumberVector<float>& _tokens, int _stride, int _count){
+
+  vector<glm::vec3> vectors;
+
+  if(_stride == 2 || _stride == 3)
+    vectors.reserve(_count);
+
+  // adding vectors of float to the position vectors
+  glm::vec3 vectorsToBeAdded;
+ 
+    for(int i=0; i<_count*_stride; i++){
+
+      // if stride is 3, group things in 3s
+      // if stride is 2, group things in 2s
+      if(_stride == 3){
+
+          if(i % _stride == 0) {
+
+          vectorsToBeAdded.x = (_tokens[i]);
+
+          } else if(i % _stride == 1){
+
+          vectorsToBeAdded.y = (_tokens[i]);
+
+          } else if(i % _stride == _stride-1){
+
+          vectorsToBeAdded.z = (_tokens[i]);
+
+          }
+
+        // vectorsToBeAdded.id = tokens.id;
+
+        // when at the end of a block, push it 
+        // to the vectors 
+        if (i % _stride == _stride-1){
+
+          vectors.push_back(vectorsToBeAdded);
+
+        }
+     
+      } else if(_stride == 2){
+
+        if(i % _stride == 0){
+          
+        vectorsToBeAdded.x = (_tokens[i]);
+
+        } else if(i % _stride == 1){
+
+        vectorsToBeAdded.y = (_tokens[i]);
         
-        // reaching the mesh node
-      for (auto& child : *geoNode) {
+        }
+
+        // vectorsToBeAdded.id = tokens.id;
 
-        if (child.name() == "mesh"){
+        if (i % _stride == _stride-1){
 
-          meshNode = &child;
-          break;
+          vectors.push_back(vectorsToBeAdded);
 
         }
-      
+
       }
 
+    }
+
+  arrayVector.push_back(move(vectors));
+
+}
+
+/*
+  void
+  ColladaLoader::
+  parseArrayIDs(XMLNode& _node){
+
+    for (auto& child : _node) {
+
+      if(child.name() == "float_array"){
+
+        idLookup.insert(   {child.read("id", true, "", "ID"), indexNum }   );
+        indexNum++;
+
+      }
+      
+    }
+    
+  }
+
+  // TODO
+  void
+  ColladaLoader::
+  parseSourceIDs(XMLNode& _node){}
+
+
+
+*/
+
+void
+ColladaLoader::
+parseGeometries(XMLNode& _node){
+
+  XMLNode* geoNode = nullptr;
+
+  // there can be more than 2 source nodes! 
+  XMLNode* sourceNode = nullptr;
+
+  // there can be more than 2 polylist nodes!
+  XMLNode* polylistNode = nullptr;
+
+  // reaching the geometry node
+  for (auto& child : _node) {
+
+    if (tagOf(child) == ColladaTag::Geometry){
+
+      geoNode = &child;
+        
+      // reaching the mesh node
+      XMLNode::iterator meshNode = findChild(*geoNode, ColladaTag::Mesh);
+
       // reaching the source node. There can be more than 2!
       for (auto& child : *meshNode) {
 
-        if (child.name() == "source"){
+        if (tagOf(child) == ColladaTag::Source){
 
           sourceNode = &child;
           
@@ -507,7 +1143,9 @@ parseGeometries(XMLNode& _node){
       // reaching the polylist node. There can be more than 2!
       for (auto& child : *meshNode) {
 
-        if (child.name() == "polylist" || child.name() == "triangles"  ){
+        ColladaTag tag = tagOf(child);
+
+        if (tag == ColladaTag::Polylist || tag == ColladaTag::Triangles){
 
           polylistNode = &child;
 
@@ -518,54 +1156,651 @@ parseGeometries(XMLNode& _node){
       
       }
 
-      fillPolylistVector();
+      storeGeometry();
+
+    }
+  
+  }
+  
+}
+
+void
+ColladaLoader::
+storeGeometry(){
 
-      // filling in the geometryToAdd information with the updated polylistVector
-      geometryToAdd.polylistCollection = polylistVector;
+  // geometry instance
+  Geometry geometryToAdd;
 
-      // adding the geometry to the vector
-      geometryVector.push_back(geometryToAdd);
+  fillPolylistVector();
 
-      
-      //clearing instance variables
-      geometryToAdd.polylistCollection.clear();
-      arrayVector.clear();
-      faceVector.clear();
-      polylistVector.clear();
+  // filling in the geometryToAdd information with the updated polylistVector
+  geometryToAdd.polylistCollection = move(polylistVector);
+
+  // adding the geometry to the vector
+  geometryVector.push_back(move(geometryToAdd));
 
-    }
   
+  //clearing instance variables
+  arrayVector.clear();
+  faceVector.clear();
+  polylistVector.clear();
+
+}
+
+unsigned
+ColladaLoader::
+arrayThreads(size_t _length){
+
+  if(m_arrayThreads <= 1 || _length < m_arrayThreadBytes)
+    return 1;
+
+  loadStats.parallelArrayBytes += _length;
+  return m_arrayThreads;
+
+}
+
+size_t
+ColladaLoader::
+capacitySlack() const{
+
+  size_t slack = (geometryVector.capacity() - geometryVector.size()) * sizeof(Geometry) +
+                 (materialVector.capacity() - materialVector.size()) * sizeof(Material);
+
+  for(const Geometry& geometry : geometryVector){
+
+    slack += (geometry.polylistCollection.capacity() -
+              geometry.polylistCollection.size()) * sizeof(Polylist);
+    slack += (geometry.materialCollection.capacity() -
+              geometry.materialCollection.size()) * sizeof(Material);
+
+    for(const Polylist& polylist : geometry.polylistCollection){
+
+      slack += (polylist.vertexCollection.capacity() -
+                polylist.vertexCollection.size()) * sizeof(Vertex);
+      slack += (polylist.indices.capacity() -
+                polylist.indices.size()) * sizeof(uint32_t);
+
+      const VertexArrays& arrays = polylist.vertexArrays;
+
+      slack += (arrays.positions.capacity() - arrays.positions.size()) * sizeof(glm::vec3);
+      slack += (arrays.normals.capacity() - arrays.normals.size()) * sizeof(glm::vec3);
+      slack += (arrays.textures.capacity() - arrays.textures.size()) * sizeof(glm::vec2);
+
+      slack += polylist.vertexBuffer.capacity() - polylist.vertexBuffer.size();
+
+    }
+
   }
-  
+
+  return slack;
+
+}
+
+// Streaming counterpart of the DOM walk in parseGeometries/parseMaterials.
+// Follows the same nodes (including taking only the first library, effect,
+// technique, etc.) and hands their contents to the same build functions, so
+// both engines fill the vectors identically.
+class ColladaLoader::StreamHandler : public XMLStreamHandler {
+
+  public:
+
+    StreamHandler(ColladaLoader& _loader, const string& _filename,
+                  unsigned _libraries);
+
+    void startElement(const string& _name,
+                      const XMLStreamAttributes& _attributes) override;
+    void text(const char* _text, size_t _length) override;
+    void endElement(const string& _name) override;
+    bool skipElement(const string& _name, size_t _depth) override;
+
+  private:
+
+    // role of an open element in the COLLADA tree
+    enum Context {
+      Ignored, Root, LibraryGeometries, Geometry, Mesh, Source, SourceArray,
+      TechniqueCommon, Accessor, Polylist, PolylistCounts, PolylistIndices,
+      LibraryEffects, Effect, ProfileCommon, Technique, Shading, Spec,
+      SpecValue
+    };
+
+    struct Frame {
+
+      Context context;
+
+      // one bit per child context already handed out, bit 0 for any child
+      unsigned seen;
+
+    };
+
+    Context childContext(Frame& _parent, ColladaTag _tag);
+
+    int readAttribute(const XMLStreamAttributes& _attributes,
+                      const string& _name, const string& _desc,
+                      bool _required = true, int _default = 0);
+
+    ColladaLoader& m_loader;
+    string m_filename;
+    unsigned m_libraries;
+
+    vector<Frame> m_stack;
+
+    NumberVector<float> m_arrayTokens;
+    NumberVector<Index> m_indexTokens;
+    NumberVector<Index> m_vcountTokens;
+    NumberVector<float> m_specTokens;
+
+    int m_stride = 0;
+    int m_count = 0;
+    bool m_accessorSeen = false;
+
+    // sizes declared by the open array, polylist and <p>
+    long long m_arrayDeclared = -1;
+    ColladaTag m_polylist = ColladaTag::Unknown;
+    long long m_polylistCount = -1;
+    long long m_offsets = 0;
+    bool m_vcountSeen = false;
+    long long m_indicesDeclared = -1;
+
+    ColladaTag m_spec = ColladaTag::Unknown;
+
+};
+
+ColladaLoader::StreamHandler::
+StreamHandler(ColladaLoader& _loader, const string& _filename,
+              unsigned _libraries) :
+  m_loader(_loader), m_filename(_filename), m_libraries(_libraries) {
+
+}
+
+bool
+ColladaLoader::StreamHandler::
+skipElement(const string& _name, size_t _depth){
+
+  return _depth == 1 && isSkipped(colladaTag(_name), m_libraries);
+
+}
+
+ColladaLoader::StreamHandler::Context
+ColladaLoader::StreamHandler::
+childContext(Frame& _parent, ColladaTag _tag){
+
+  Context context = Ignored;
+
+  switch(_parent.context){
+
+    case LibraryGeometries:
+      if(_tag == ColladaTag::Geometry)
+        return Geometry;
+      break;
+
+    case Mesh:
+      // there can be more than 2 source and polylist nodes!
+      if(_tag == ColladaTag::Source)
+        return Source;
+      if(_tag == ColladaTag::Polylist || _tag == ColladaTag::Triangles)
+        return Polylist;
+      break;
+
+    case Shading:
+      // since there are more than one property stored
+      return Spec;
+
+    case Root:
+      if(_tag == ColladaTag::LibraryGeometries)
+        context = LibraryGeometries;
+      else if(_tag == ColladaTag::LibraryEffects)
+        context = LibraryEffects;
+      break;
+
+    case Geometry:
+      if(_tag == ColladaTag::Mesh)
+        context = Mesh;
+      break;
+
+    case Source:
+      // the first child holds the array
+      if(!(_parent.seen & 1))
+        context = SourceArray;
+      else if(_tag == ColladaTag::TechniqueCommon)
+        context = TechniqueCommon;
+      break;
+
+    case TechniqueCommon:
+      if(_tag == ColladaTag::Accessor)
+        context = Accessor;
+      break;
+
+    case Polylist:
+      if(_tag == ColladaTag::P)
+        context = PolylistIndices;
+      else if(_tag == ColladaTag::Vcount)
+        context = PolylistCounts;
+      break;
+
+    case LibraryEffects:
+      if(_tag == ColladaTag::Effect)
+        context = Effect;
+      break;
+
+    case Effect:
+      if(_tag == ColladaTag::ProfileCOMMON)
+        context = ProfileCommon;
+      break;
+
+    case ProfileCommon:
+      if(_tag == ColladaTag::Technique)
+        context = Technique;
+      break;
+
+    case Technique:
+      if(isShading(_tag))
+        context = Shading;
+      break;
+
+    case Spec:
+      // the first child holds the value, unless it is a texture
+      if(!(_parent.seen & 1) && _tag != ColladaTag::Texture)
+        context = SpecValue;
+      break;
+
+    default:
+      break;
+
+  }
+
+  // like the DOM walk, only the first matching child is followed
+  unsigned bit = 1u << context;
+  if(_parent.seen & bit)
+    context = Ignored;
+
+  _parent.seen |= bit | 1u;
+
+  return context;
+
+}
+
+int
+ColladaLoader::StreamHandler::
+readAttribute(const XMLStreamAttributes& _attributes, const string& _name,
+              const string& _desc, bool _required, int _default){
+
+  const string* value = _attributes.find(_name);
+
+  if(!value && !_required)
+    return _default;
+
+  if(!value)
+    throw ParseException("File: " + m_filename,
+        "Missing required attribute '" + _name + "'.\n\tAttribute description: " +
+        _desc + ".");
+
+  // same checks as XMLNode::readInt with the bounds the DOM path uses
+  int number;
+  if(!parseAttribute(value->c_str(), number))
+    throw ParseException("File: " + m_filename,
+        "Wrong attribute type requested on '" + _name + "'.\n\tAttribute description: " +
+        _desc + ".");
+
+  if(number < 0)
+    throw ParseException("File: " + m_filename,
+        "Invalid attribute range on '" + _name + "'.\n\tAttribute description: " +
+        _desc + ".\n\tValid range: [0, " + to_string(INT_MAX) + "].");
+
+  return number;
+
+}
+
+void
+ColladaLoader::StreamHandler::
+startElement(const string& _name, const XMLStreamAttributes& _attributes){
+
+  Context context;
+  ColladaTag tag = colladaTag(_name);
+
+  if(m_stack.empty()){
+
+    // getting the root node of the tree
+    if(tag != ColladaTag::COLLADA)
+      throw ParseException(m_filename, "Unable to find XML node 'COLLADA'.");
+
+    context = Root;
+
+  } else if(m_stack.back().context == Ignored){
+
+    // nothing below an ignored node is of interest
+    context = Ignored;
+
+  } else{
+
+    context = childContext(m_stack.back(), tag);
+
+  }
+
+  switch(context){
+
+    case Polylist:
+      m_indexTokens.clear();
+      m_vcountTokens.clear();
+      m_polylist = tag;
+      m_polylistCount = readAttribute(_attributes, "count", "Count", false, -1);
+      m_offsets = 0;
+      m_loader.numOfInput = 0;
+      m_vcountSeen = false;
+      break;
+
+    case PolylistCounts:
+      m_vcountSeen = true;
+      break;
+
+    case PolylistIndices:
+      // <vcount> comes before <p>
+      m_indicesDeclared = declaredIndices(m_polylist, m_polylistCount,
+          m_vcountSeen ? &m_vcountTokens : nullptr, m_offsets);
+      break;
+
+    case SourceArray:
+      m_arrayTokens.clear();
+      m_arrayDeclared = readAttribute(_attributes, "count", "Count", false, -1);
+      m_accessorSeen = false;
+      break;
+
+    case Accessor:
+      // reading accessor node attributes
+      m_stride = readAttribute(_attributes, "stride", "Stride");
+      m_count = readAttribute(_attributes, "count", "Count");
+      m_accessorSeen = true;
+      break;
+
+    case Spec:
+      m_spec = tag;
+      m_specTokens.clear();
+      break;
+
+    default:
+      break;
+
+  }
+
+  // incrementing this allows us to see how many parameters per vertex
+  if(tag == ColladaTag::Input && !m_stack.empty() && m_stack.back().context == Polylist){
+
+    m_loader.numOfInput++;
+
+    m_offsets = max(m_offsets,
+        readAttribute(_attributes, "offset", "Offset", false, 0) + 1ll);
+
+  }
+
+  m_stack.push_back({context, 0});
+
+}
+
+void
+ColladaLoader::StreamHandler::
+text(const char* _text, size_t _length){
+
+  switch(m_stack.back().context){
+
+    case SourceArray:
+      reserveDeclared(m_arrayTokens, m_arrayDeclared, _length);
+      tokenize(_text, _text + _length, m_arrayTokens,
+               m_loader.arrayThreads(_length));
+      break;
+
+    case PolylistCounts:
+      tokenize(_text, _text + _length, m_vcountTokens);
+      break;
+
+    case PolylistIndices:
+      reserveDeclared(m_indexTokens, m_indicesDeclared, _length);
+      tokenize(_text, _text + _length, m_indexTokens,
+               m_loader.arrayThreads(_length));
+      break;
+
+    case SpecValue:
+      tokenize(_text, _text + _length, m_specTokens);
+      break;
+
+    default:
+      break;
+
+  }
+
+}
+
+void
+ColladaLoader::StreamHandler::
+endElement(const string& _name){
+
+  Context context = m_stack.back().context;
+  m_stack.pop_back();
+
+  switch(context){
+
+    case Source:
+      if(!m_accessorSeen)
+        throw ParseException("File: " + m_filename,
+            "Source without an accessor.");
+      checkAccessor("File: " + m_filename, m_stride, m_count,
+                    m_arrayTokens.size());
+      m_loader.buildSourceVectors(m_arrayTokens, m_stride, m_count);
+      NumberVector<float>().swap(m_arrayTokens);
+      break;
+
+    case SourceArray:
+      checkDeclared("File: " + m_filename, _name, m_arrayDeclared,
+                    m_arrayTokens.size());
+      break;
+
+    case PolylistIndices:
+      checkDeclared("File: " + m_filename, _name, m_indicesDeclared,
+                    m_indexTokens.size());
+      break;
+
+    case Polylist:
+      m_loader.buildFaceVectors(m_indexTokens, m_offsets);
+      NumberVector<Index>().swap(m_indexTokens);
+      break;
+
+    case Geometry:
+      m_loader.storeGeometry();
+      break;
+
+    case SpecValue:
+      m_loader.applySpec(m_spec, m_specTokens);
+      break;
+
+    case Spec:
+      // add to the material vector
+      m_loader.materialVector.push_back(m_loader.material);
+      break;
+
+    default:
+      break;
+
+  }
+
+}
+
+// the streaming engine, kept between begin() and finish()
+struct ColladaLoader::Feed {
+
+  Feed(ColladaLoader& _loader, const string& _name, unsigned _libraries) :
+    handler(_loader, _name, _libraries), parser(handler, _name) {}
+
+  StreamHandler handler;
+  XMLStreamParser parser;
+
+};
+
+// out of line, where Feed is complete
+ColladaLoader::
+~ColladaLoader() = default;
+
+void
+ColladaLoader::
+begin(const string& _name){
+
+  begin(_name, LoadOptions());
+
+}
+
+void
+ColladaLoader::
+begin(const string& _name, const LoadOptions& _options){
+
+  // counters of this load only
+  loadStats = LoadStats();
+
+  // nothing left over from the last load
+  numOfInput = 0;
+  material = Material();
+
+  // a bad layout throws before anything is set up
+  m_feed.reset();
+  setOutput(_options);
+
+  geometryVector.clear();
+  materialVector.clear();
+
+  // the DOM engine needs the whole file before it can start, so pushed
+  // input always goes through the streaming one
+  m_feed = make_unique<Feed>(*this, _name, _options.libraries);
+
+  m_arrayThreads = _options.arrayThreads;
+  m_arrayThreadBytes = _options.arrayThreadBytes;
+
 }
 
 void
 ColladaLoader::
+feed(const char* _data, size_t _length){
+
+  if(!m_feed)
+    throw RunTimeException(WHERE, "feed() called without begin().");
+
+  m_feed->parser.feed(_data, _length);
+
+}
+
+ColladaLoader::Scene
+ColladaLoader::
+takeScene(){
+
+  loadStats.capacitySlackBytes = capacitySlack();
+
+  Scene scene;
+
+  scene.m_geometries = move(geometryVector);
+  scene.m_materials = move(materialVector);
+  scene.m_stats = loadStats;
+
+  geometryVector.clear();
+  materialVector.clear();
+
+  return scene;
+
+}
+
+ColladaLoader::Scene
+ColladaLoader::
+finish(){
+
+  if(!m_feed)
+    throw RunTimeException(WHERE, "finish() called without begin().");
+
+  // done with the input either way
+  unique_ptr<Feed> feed = move(m_feed);
+
+  feed->parser.finish();
+
+  loadStats.bytesRead = feed->parser.bytesRead();
+  loadStats.bytesSkipped = feed->parser.bytesSkipped();
+
+  return takeScene();
+
+}
+
+ColladaLoader::Scene
+ColladaLoader::
 parseCollada(const string& _filename, const string& _desiredNode){
 
-  // getting the root node of the tree
-  XMLNode rootNode(_filename, "COLLADA");
+  return parseCollada(_filename, _desiredNode, LoadOptions());
 
-  // Find the 'library_geometries' and 'library_effects nodes
-  XMLNode* libGeoNode = nullptr;
-  XMLNode* libEffNode = nullptr;
+}
 
-  for (auto& child : rootNode) {
+ColladaLoader::Scene
+ColladaLoader::
+parseCollada(const string& _filename, const string& _desiredNode,
+             const LoadOptions& _options){
 
-    if (child.name() == "library_geometries" && !libGeoNode){
+  // counters of this load only
+  loadStats = LoadStats();
 
-       libGeoNode = &child;
+  // nothing left over from the last load
+  numOfInput = 0;
+  material = Material();
 
-    } else if(child.name() == "library_effects" && !libEffNode){
+  m_arrayThreads = _options.arrayThreads;
+  m_arrayThreadBytes = _options.arrayThreadBytes;
+  setOutput(_options);
 
-        libEffNode = &child;
+  // nothing left over from a load that failed
+  geometryVector.clear();
+  materialVector.clear();
+
+  if(_options.streaming){
+
+    // feeding the loader as elements close, without a DOM
+    StreamHandler handler(*this, _filename, _options.libraries);
+    XMLStreamParser parser(handler, _filename);
+
+    parser.parseFile(_filename);
+
+    loadStats.bytesRead = parser.bytesRead();
+    loadStats.bytesSkipped = parser.bytesSkipped();
+    loadStats.compressedBytes = parser.compressedBytes();
+    loadStats.decompressSeconds = parser.decompressSeconds();
+
+    return takeScene();
 
-    }
-     
   }
 
-  parseGeometries(*libGeoNode);
+  // getting the root node of the tree
+  LibraryFilter filter(_options.libraries);
+
+  XMLLoadOptions xmlOptions = _options.xml;
+  xmlOptions.interner = internTag;
+  xmlOptions.skipFilter = &filter;
+
+  // the tokenizer treats all white space alike, so numeric text doesn't
+  // need condensing
+  xmlOptions.rawText = true;
+
+  // warnAll is never called, so nothing needs to know what was read
+  xmlOptions.tracking = false;
+
+  // error messages only need the line; parse errors are exact anyway
+  xmlOptions.exactLocation = false;
+
+  XMLNode rootNode(_filename, "COLLADA", xmlOptions);
+
+  loadStats.bytesRead = rootNode.loadStats().bytesRead;
+  loadStats.bytesSkipped = rootNode.loadStats().bytesSkipped;
+  loadStats.compressedBytes = rootNode.loadStats().compressedBytes;
+  loadStats.decompressSeconds = rootNode.loadStats().decompressSeconds;
+  loadStats.parallelTextBytes = rootNode.loadStats().parallelTextBytes;
+
+  // Find the 'library_geometries' and 'library_effects nodes
+  XMLNode::iterator libGeoNode = findChild(rootNode, ColladaTag::LibraryGeometries);
+  XMLNode::iterator libEffNode = findChild(rootNode, ColladaTag::LibraryEffects);
+
+  if(libGeoNode != rootNode.end())
+    parseGeometries(*libGeoNode);
+
+  if(libEffNode != rootNode.end())
+    parseMaterials(*libEffNode);
 
-  parseMaterials(*libEffNode);
+  return takeScene();
 
 }
\ No newline at end of file
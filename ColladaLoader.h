@@ -1,13 +1,19 @@
 #ifndef _COLLADA_LOADER_H_
 #define _COLLADA_LOADER_H_
 
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <unordered_map>
 
 #include <XMLNode.h>
+#include <XMLStreamParser.h>
+#include <ColladaTags.h>
 #include <glm/vec2.hpp> 
 #include <glm/vec3.hpp> 
 #include <glm/vec4.hpp> 
@@ -16,10 +22,103 @@ class XMLNode;
 
 using namespace std;
 
+// read-only window on a run of T held somewhere else, valid for as long
+// as its owner is
+template<typename T>
+  class ConstView {
+
+    public:
+
+      typedef const T* iterator;
+
+      ConstView(const T* _begin = nullptr, size_t _size = 0) :
+        m_begin(_begin), m_size(_size) {}
+
+      iterator begin() const {return m_begin;}
+      iterator end() const {return m_begin + m_size;}
+
+      size_t size() const {return m_size;}
+      bool empty() const {return m_size == 0;}
+
+      const T& operator[](size_t _i) const {return m_begin[_i];}
+      const T* data() const {return m_begin;}
+
+    private:
+
+      const T* m_begin;
+      size_t m_size;
+
+  };
+
+// allocator for vectors that SIMD code reads: every block starts on an
+// Align byte boundary and is padded to a whole number of Align bytes,
+// so whole registers can be loaded up to the end of the data
+template<typename T, size_t Align>
+  struct AlignedAllocator {
+
+    typedef T value_type;
+
+    template<typename U>
+      struct rebind {
+
+        typedef AlignedAllocator<U, Align> other;
+
+      };
+
+    AlignedAllocator() = default;
+
+    template<typename U>
+      AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t _n) {
+
+      if(_n > (SIZE_MAX - Align) / sizeof(T))
+        throw bad_alloc();
+
+      void* block;
+      if(posix_memalign(&block, Align, (_n * sizeof(T) + Align - 1) / Align * Align))
+        throw bad_alloc();
+
+      return static_cast<T*>(block);
+
+    }
+
+    void deallocate(T* _block, size_t) {
+
+      free(_block);
+
+    }
+
+  };
+
+template<typename T, typename U, size_t Align>
+  bool
+  operator==(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&) {
+
+    return true;
+
+  }
+
+template<typename T, typename U, size_t Align>
+  bool
+  operator!=(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&) {
+
+    return false;
+
+  }
+
 class ColladaLoader{
 
   public:
 
+    // an index read from <p>. define COLLADA_64BIT_INDICES for meshes
+    // with 2^32 or more of anything
+#ifdef COLLADA_64BIT_INDICES
+    typedef uint64_t Index;
+#else
+    typedef uint32_t Index;
+#endif
+
     struct Vertex {
 
       glm::vec3 position;
@@ -48,9 +147,82 @@ class ColladaLoader{
 
     };  
 
+    // a vector starting on a cache line
+    template<typename T>
+      using AlignedVector = vector< T, AlignedAllocator<T, 64> >;
+
+    // the attributes of the vertices of a polylist, each in an array of
+    // its own, for code that only reads some of them
+    struct VertexArrays {
+
+      AlignedVector < glm::vec3 > positions;
+      AlignedVector < glm::vec3 > normals;
+      AlignedVector < glm::vec2 > textures;
+
+    };
+
+    // one attribute of the vertices in an interleaved vertex buffer
+    struct VertexAttribute {
+
+      enum Semantic {
+
+        Position,
+        Normal,
+        Texture
+
+      };
+
+      // the type and number of components written. snorm and unorm are
+      // integers standing for [-1, 1] and [0, 1], and half a 16 bit
+      // float. components the attribute doesn't have (the w of a
+      // normal in Snorm16x4, say) are written as 0; those the format
+      // has no room for are left out
+      enum Format {
+
+        Float2, Float3, Float4,
+        Half2, Half4,
+        Snorm16x2, Snorm16x4, Unorm16x2,
+        Snorm8x4, Unorm8x4
+
+      };
+
+      Semantic semantic;
+      Format format;
+
+      // where the attribute starts, in bytes from the start of the vertex
+      size_t offset;
+
+      // bytes the format takes
+      size_t size() const;
+
+    };
+
+    // how the vertices of an interleaved vertex buffer are laid out:
+    // stride bytes each, holding the attributes at their offsets. bytes
+    // no attribute covers are 0
+    struct VertexLayout {
+
+      vector < VertexAttribute > attributes;
+      size_t stride = 0;
+
+    };
+
     struct Polylist {
 
       vector < Vertex > vertexCollection;
+
+      // with LoadOptions::separateArrays, the same vertices filled in
+      // here instead of in vertexCollection
+      VertexArrays vertexArrays;
+
+      // with a LoadOptions::vertexLayout, the same vertices filled in
+      // here instead, in that layout
+      AlignedVector < unsigned char > vertexBuffer;
+
+      // with LoadOptions::indexed, the vertex of every corner in <p>
+      // order; vertexCollection (or vertexArrays) then holds each
+      // distinct vertex once. empty otherwise
+      vector < uint32_t > indices;
       
     };
 
@@ -61,8 +233,122 @@ class ColladaLoader{
 
     };
 
+    struct LoadOptions {
+
+      // parse with the event-driven XMLStreamParser instead of building
+      // the whole DOM first; produces the same vectors
+      bool streaming = false;
+
+      // how the DOM engine reads the file
+      XMLLoadOptions xml;
+
+      enum Library {
+
+        Geometries = 1,
+        Effects = 2
+
+      };
+
+      // libraries to read. the others, and everything else at the top
+      // level of the file, are skipped over without being parsed
+      unsigned libraries = Geometries | Effects;
+
+      // threads decoding one long array (<float_array>, <p>), this one
+      // included. arrays shorter than arrayThreadBytes characters are
+      // decoded on this thread alone
+      unsigned arrayThreads = 1;
+      size_t arrayThreadBytes = 1 << 20;
+
+      // fill Polylist::indices and keep one copy of each distinct vertex
+      // instead of one vertex per corner. polylists of at least
+      // dedupThreadCorners corners are deduplicated on arrayThreads
+      // threads
+      bool indexed = false;
+      size_t dedupThreadCorners = 1 << 18;
+
+      // fill Polylist::vertexArrays rather than vertexCollection
+      bool separateArrays = false;
+
+      // with attributes, fill Polylist::vertexBuffer in this layout
+      // rather than vertexCollection or vertexArrays
+      VertexLayout vertexLayout;
+
+    };
+
+    struct LoadStats {
+
+      // size of the input file, after decompression
+      size_t bytesRead = 0;
+
+      // size of the input file if it is gzip compressed, else 0
+      size_t compressedBytes = 0;
+
+      // time spent decompressing it
+      double decompressSeconds = 0;
+
+      // input bytes skipped over because of LoadOptions::libraries
+      size_t bytesSkipped = 0;
+
+      // text decoded on worker threads because of xml.textThreads
+      size_t parallelTextBytes = 0;
+
+      // array text decoded on several threads because of arrayThreads
+      size_t parallelArrayBytes = 0;
+
+      // corners deduplicated on several threads because of arrayThreads
+      size_t parallelDedupCorners = 0;
+
+      // memory held by the result vectors beyond their size. arrays and
+      // polylists are sized from their declared counts, so this is mostly
+      // the growth of the geometry and material lists
+      size_t capacitySlackBytes = 0;
+
+    };
+
+    // what a load produced. owns the geometries and materials; moved
+    // rather than copied, and read through const views
+    class Scene {
+
+      public:
+
+        Scene() = default;
+
+        Scene(Scene&&) = default;
+        Scene& operator=(Scene&&) = default;
+
+        Scene(const Scene&) = delete;
+        Scene& operator=(const Scene&) = delete;
+
+        ConstView<Geometry> geometries() const {
+          return ConstView<Geometry>(m_geometries.data(), m_geometries.size());
+        }
+
+        ConstView<Material> materials() const {
+          return ConstView<Material>(m_materials.data(), m_materials.size());
+        }
+
+        // counters describing the load
+        const LoadStats& stats() const {return m_stats;}
+
+      private:
+
+        friend class ColladaLoader;
+
+        vector < Geometry > m_geometries;
+        vector < Material > m_materials;
+        LoadStats m_stats;
+
+    };
+
     ColladaLoader();
 
+    // the state kept between begin() and finish() has a single owner, so
+    // a loader can't be copied
+    ColladaLoader(const ColladaLoader&) = delete;
+    ColladaLoader& operator=(const ColladaLoader&) = delete;
+
+    ~ColladaLoader();
+
     // void parseArrayIDs(XMLNode& _node);
     // void parseSourceIDs(XMLNode& _node);
 
@@ -71,7 +357,21 @@ class ColladaLoader{
 
     void parseSourceNode(XMLNode& _node);
     void parsePolylistNode(XMLNode& _node);
-    void parseCollada(const string& _filename, const string& _desiredNode);
+    Scene parseCollada(const string& _filename, const string& _desiredNode);
+    Scene parseCollada(const string& _filename, const string& _desiredNode,
+                       const LoadOptions& _options);
+
+    // incremental loading, for input that arrives in pieces (pipes, chunked
+    // downloads). call begin(), then feed() every piece as it comes, split
+    // anywhere, then finish(). parsing happens as the pieces are fed, with
+    // the streaming engine whatever _options.streaming says, and finish()
+    // returns the same scene as parseCollada. _name is only used in error
+    // messages. errors throw ParseException; call begin() again to start
+    // over
+    void begin(const string& _name, const LoadOptions& _options);
+    void begin(const string& _name = "");
+    void feed(const char* _data, size_t _length);
+    Scene finish();
     
     void parseGeometries(XMLNode& _node);
     void parseMaterials(XMLNode& _node);
@@ -80,6 +380,8 @@ class ColladaLoader{
 
     void fillPolylistVector();
 
+  private:
+
     int indexNum;
     
     int numOfInput;
@@ -89,16 +391,70 @@ class ColladaLoader{
 
     vector < vector<glm::vec3> > arrayVector;
 
-    vector < vector<glm::vec3> > faceVector;
+    // the position, normal and texture coordinate index of every corner
+    vector < vector< glm::vec<3, Index> > > faceVector;
 
     Material material;
 
     vector < Polylist > polylistVector;
+
+    // counters of the current load, handed over with the scene
+    LoadStats loadStats;
+
+    // the scene being loaded, handed over whole at the end
     vector < Material > materialVector;
     vector < Geometry > geometryVector;
 
-  private:
-  
+    // moves the loaded scene out, leaving the loader empty for the next
+    // load
+    Scene takeScene();
+
+    class StreamHandler;
+    struct Feed;
+
+    // state between begin() and finish(), empty otherwise
+    unique_ptr<Feed> m_feed;
+
+    // LoadOptions::arrayThreads and arrayThreadBytes of the current load
+    unsigned m_arrayThreads = 1;
+    size_t m_arrayThreadBytes = 0;
+
+    // LoadOptions::indexed and dedupThreadCorners of the current load
+    bool m_indexed = false;
+    size_t m_dedupThreadCorners = 0;
+
+    // LoadOptions::separateArrays and vertexLayout of the current load
+    bool m_separateArrays = false;
+    VertexLayout m_vertexLayout;
+
+    // takes the vertex output options of a load, checking the layout
+    void setOutput(const LoadOptions& _options);
+
+    // threads to decode an array of _length characters on; counts the
+    // array in loadStats if that is more than one
+    unsigned arrayThreads(size_t _length);
+
+    // LoadStats::capacitySlackBytes of the vectors as they are
+    size_t capacitySlack() const;
+
+    // makes room for _count vertices in _polylist, and appends the
+    // vertex of _corner to it; in vertexCollection, vertexArrays or
+    // vertexBuffer, whichever the load fills
+    void reserveVertices(Polylist& _polylist, size_t _count);
+    void addVertex(Polylist& _polylist, const glm::vec<3, Index>& _corner);
+
+    // fills _polylist with the distinct vertices of _corners and an
+    // index per corner
+    void indexPolylist(const vector< glm::vec<3, Index> >& _corners,
+                       Polylist& _polylist);
+
+    // shared by the DOM and the streaming engines
+    void buildSourceVectors(const NumberVector<float>& _tokens, int _stride, int _count);
+    // _offsets is the number of indices per vertex in _tokens
+    void buildFaceVectors(const NumberVector<Index>& _tokens, long long _offsets);
+    void applySpec(ColladaTag _spec, const NumberVector<float>& _tokens);
+    void storeGeometry();
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <ColladaTags.h>
+
+#include <cstring>
+
+namespace {
+
+  // element names, indexed by tag
+  constexpr const char* tagNames[] = {
+
+#define COLLADA_TAG_NAME(_id, _name) _name,
+    COLLADA_TAGS(COLLADA_TAG_NAME)
+#undef COLLADA_TAG_NAME
+
+  };
+
+  constexpr size_t numTags = sizeof(tagNames) / sizeof(tagNames[0]);
+
+  // the hash picks one of 2^tableBits slots
+  constexpr int tableBits = 12;
+  constexpr size_t tableSize = size_t(1) << tableBits;
+
+  // found offline: with this basis no two names of the vocabulary
+  // share a slot. has to be searched again whenever a name is added
+  // (the static_assert below fails until it is)
+  constexpr uint32_t hashSeed = 0xc6347b98u;
+
+  constexpr size_t
+  nameLength(const char* _name){
+
+    size_t length = 0;
+
+    while(_name[length])
+      length++;
+
+    return length;
+
+  }
+
+  // FNV-1a with a searched basis; the top bits are the best mixed
+  constexpr size_t
+  hashName(const char* _name, size_t _length){
+
+    uint32_t hash = hashSeed;
+
+    for(size_t i=0; i<_length; i++){
+
+      hash ^= (unsigned char)_name[i];
+      hash *= 16777619u;
+
+    }
+
+    return hash >> (32 - tableBits);
+
+  }
+
+  struct Table {
+
+    // tag in each slot, Unknown for empty slots
+    uint16_t slots[tableSize];
+
+    // name lengths, indexed by tag
+    uint8_t lengths[numTags];
+
+  };
+
+  constexpr Table
+  buildTable(){
+
+    Table table = {};
+
+    for(size_t i=0; i<tableSize; i++)
+      table.slots[i] = uint16_t(ColladaTag::Unknown);
+
+    for(size_t tag=0; tag<numTags; tag++){
+
+      table.lengths[tag] = uint8_t(nameLength(tagNames[tag]));
+      table.slots[hashName(tagNames[tag], table.lengths[tag])] = uint16_t(tag);
+
+    }
+
+    return table;
+
+  }
+
+  constexpr Table table = buildTable();
+
+  // true when every name landed in a slot of its own
+  constexpr bool
+  isPerfect(){
+
+    for(size_t tag=0; tag<numTags; tag++)
+      if(table.slots[hashName(tagNames[tag], table.lengths[tag])] != tag)
+        return false;
+
+    return true;
+
+  }
+
+  static_assert(numTags == size_t(ColladaTag::Unknown), "tag names out of step with ColladaTag");
+  static_assert(isPerfect(), "hashSeed no longer gives every tag its own slot");
+
+}
+
+ColladaTag
+colladaTag(const char* _name, size_t _length){
+
+  uint16_t tag = table.slots[hashName(_name, _length)];
+
+  // an unknown name may still land on a used slot
+  if(tag == uint16_t(ColladaTag::Unknown) || table.lengths[tag] != _length ||
+     memcmp(tagNames[tag], _name, _length) != 0)
+    return ColladaTag::Unknown;
+
+  return ColladaTag(tag);
+
+}
+
+const char*
+colladaTagName(ColladaTag _tag){
+
+  return _tag == ColladaTag::Unknown ? "" : tagNames[size_t(_tag)];
+
+}
@@ -0,0 +1,369 @@
+#ifndef _COLLADA_TAGS_H_
+#define _COLLADA_TAGS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// the COLLADA 1.4/1.5 element vocabulary, as X(enumerator, "name")
+#define COLLADA_TAGS(X) \
+  /* core, asset */ \
+  X(COLLADA, "COLLADA") \
+  X(Asset, "asset") \
+  X(Contributor, "contributor") \
+  X(Author, "author") \
+  X(AuthorEmail, "author_email") \
+  X(AuthorWebsite, "author_website") \
+  X(AuthoringTool, "authoring_tool") \
+  X(Comments, "comments") \
+  X(Copyright, "copyright") \
+  X(SourceData, "source_data") \
+  X(Created, "created") \
+  X(Keywords, "keywords") \
+  X(Modified, "modified") \
+  X(Revision, "revision") \
+  X(Subject, "subject") \
+  X(Title, "title") \
+  X(Unit, "unit") \
+  X(UpAxis, "up_axis") \
+  X(Coverage, "coverage") \
+  X(GeographicLocation, "geographic_location") \
+  X(Longitude, "longitude") \
+  X(Latitude, "latitude") \
+  X(Altitude, "altitude") \
+  /* libraries */ \
+  X(LibraryAnimations, "library_animations") \
+  X(LibraryAnimationClips, "library_animation_clips") \
+  X(LibraryCameras, "library_cameras") \
+  X(LibraryControllers, "library_controllers") \
+  X(LibraryEffects, "library_effects") \
+  X(LibraryForceFields, "library_force_fields") \
+  X(LibraryGeometries, "library_geometries") \
+  X(LibraryImages, "library_images") \
+  X(LibraryLights, "library_lights") \
+  X(LibraryMaterials, "library_materials") \
+  X(LibraryNodes, "library_nodes") \
+  X(LibraryPhysicsMaterials, "library_physics_materials") \
+  X(LibraryPhysicsModels, "library_physics_models") \
+  X(LibraryPhysicsScenes, "library_physics_scenes") \
+  X(LibraryVisualScenes, "library_visual_scenes") \
+  X(LibraryFormulas, "library_formulas") \
+  X(LibraryArticulatedSystems, "library_articulated_systems") \
+  X(LibraryKinematicsModels, "library_kinematics_models") \
+  X(LibraryKinematicsScenes, "library_kinematics_scenes") \
+  X(LibraryJoints, "library_joints") \
+  /* animation */ \
+  X(Animation, "animation") \
+  X(AnimationClip, "animation_clip") \
+  X(Channel, "channel") \
+  X(Sampler, "sampler") \
+  X(InstanceAnimation, "instance_animation") \
+  /* camera */ \
+  X(Camera, "camera") \
+  X(Optics, "optics") \
+  X(TechniqueCommon, "technique_common") \
+  X(Orthographic, "orthographic") \
+  X(Perspective, "perspective") \
+  X(Xmag, "xmag") \
+  X(Ymag, "ymag") \
+  X(Xfov, "xfov") \
+  X(Yfov, "yfov") \
+  X(AspectRatio, "aspect_ratio") \
+  X(Znear, "znear") \
+  X(Zfar, "zfar") \
+  X(Imager, "imager") \
+  /* controller */ \
+  X(Controller, "controller") \
+  X(Skin, "skin") \
+  X(BindShapeMatrix, "bind_shape_matrix") \
+  X(Joints, "joints") \
+  X(VertexWeights, "vertex_weights") \
+  X(V, "v") \
+  X(Vcount, "vcount") \
+  X(Morph, "morph") \
+  X(Targets, "targets") \
+  /* geometry */ \
+  X(Geometry, "geometry") \
+  X(Mesh, "mesh") \
+  X(ConvexMesh, "convex_mesh") \
+  X(Spline, "spline") \
+  X(ControlVertices, "control_vertices") \
+  X(Brep, "brep") \
+  X(Source, "source") \
+  X(Vertices, "vertices") \
+  X(Lines, "lines") \
+  X(Linestrips, "linestrips") \
+  X(Polygons, "polygons") \
+  X(Polylist, "polylist") \
+  X(Triangles, "triangles") \
+  X(Trifans, "trifans") \
+  X(Tristrips, "tristrips") \
+  X(Input, "input") \
+  X(P, "p") \
+  X(Ph, "ph") \
+  X(H, "h") \
+  /* arrays */ \
+  X(FloatArray, "float_array") \
+  X(IntArray, "int_array") \
+  X(BoolArray, "bool_array") \
+  X(NameArray, "Name_array") \
+  X(IDREFArray, "IDREF_array") \
+  X(SIDREFArray, "SIDREF_array") \
+  X(TokenArray, "token_array") \
+  X(Accessor, "accessor") \
+  X(Param, "param") \
+  /* light */ \
+  X(Light, "light") \
+  X(Ambient, "ambient") \
+  X(Directional, "directional") \
+  X(Point, "point") \
+  X(Spot, "spot") \
+  X(Color, "color") \
+  X(ConstantAttenuation, "constant_attenuation") \
+  X(LinearAttenuation, "linear_attenuation") \
+  X(QuadraticAttenuation, "quadratic_attenuation") \
+  X(FalloffAngle, "falloff_angle") \
+  X(FalloffExponent, "falloff_exponent") \
+  /* material */ \
+  X(Material, "material") \
+  X(InstanceEffect, "instance_effect") \
+  X(TechniqueHint, "technique_hint") \
+  X(Setparam, "setparam") \
+  /* scene graph */ \
+  X(Node, "node") \
+  X(Lookat, "lookat") \
+  X(Matrix, "matrix") \
+  X(Rotate, "rotate") \
+  X(Scale, "scale") \
+  X(Skew, "skew") \
+  X(Translate, "translate") \
+  X(InstanceCamera, "instance_camera") \
+  X(InstanceController, "instance_controller") \
+  X(InstanceGeometry, "instance_geometry") \
+  X(InstanceLight, "instance_light") \
+  X(InstanceNode, "instance_node") \
+  X(Skeleton, "skeleton") \
+  X(BindMaterial, "bind_material") \
+  X(InstanceMaterial, "instance_material") \
+  X(Bind, "bind") \
+  X(BindVertexInput, "bind_vertex_input") \
+  /* visual scene */ \
+  X(VisualScene, "visual_scene") \
+  X(EvaluateScene, "evaluate_scene") \
+  X(Render, "render") \
+  X(Layer, "layer") \
+  X(Scene, "scene") \
+  X(InstanceVisualScene, "instance_visual_scene") \
+  X(InstancePhysicsScene, "instance_physics_scene") \
+  X(InstanceKinematicsScene, "instance_kinematics_scene") \
+  /* extra */ \
+  X(Extra, "extra") \
+  X(Technique, "technique") \
+  /* FX */ \
+  X(Effect, "effect") \
+  X(Annotate, "annotate") \
+  X(Newparam, "newparam") \
+  X(Modifier, "modifier") \
+  X(Semantic, "semantic") \
+  X(ProfileCOMMON, "profile_COMMON") \
+  X(ProfileGLSL, "profile_GLSL") \
+  X(ProfileGLES, "profile_GLES") \
+  X(ProfileGLES2, "profile_GLES2") \
+  X(ProfileCG, "profile_CG") \
+  X(ProfileBRIDGE, "profile_BRIDGE") \
+  X(Image, "image") \
+  X(InitFrom, "init_from") \
+  X(Create2d, "create_2d") \
+  X(Create3d, "create_3d") \
+  X(CreateCube, "create_cube") \
+  X(Renderable, "renderable") \
+  X(Ref, "ref") \
+  X(Hex, "hex") \
+  X(Surface, "surface") \
+  X(Format, "format") \
+  /* FX samplers */ \
+  X(Sampler1D, "sampler1D") \
+  X(Sampler2D, "sampler2D") \
+  X(Sampler3D, "sampler3D") \
+  X(SamplerCUBE, "samplerCUBE") \
+  X(SamplerRECT, "samplerRECT") \
+  X(SamplerDEPTH, "samplerDEPTH") \
+  X(WrapS, "wrap_s") \
+  X(WrapT, "wrap_t") \
+  X(WrapP, "wrap_p") \
+  X(Minfilter, "minfilter") \
+  X(Magfilter, "magfilter") \
+  X(Mipfilter, "mipfilter") \
+  X(BorderColor, "border_color") \
+  X(MipMaxLevel, "mip_max_level") \
+  X(MipMinLevel, "mip_min_level") \
+  X(MipBias, "mip_bias") \
+  X(MaxAnisotropy, "max_anisotropy") \
+  X(InstanceImage, "instance_image") \
+  /* FX common profile */ \
+  X(Constant, "constant") \
+  X(Lambert, "lambert") \
+  X(Phong, "phong") \
+  X(Blinn, "blinn") \
+  X(Emission, "emission") \
+  X(Diffuse, "diffuse") \
+  X(Specular, "specular") \
+  X(Shininess, "shininess") \
+  X(Reflective, "reflective") \
+  X(Reflectivity, "reflectivity") \
+  X(Transparent, "transparent") \
+  X(Transparency, "transparency") \
+  X(IndexOfRefraction, "index_of_refraction") \
+  X(Texture, "texture") \
+  /* FX parameter types */ \
+  X(Float, "float") \
+  X(Float2, "float2") \
+  X(Float3, "float3") \
+  X(Float4, "float4") \
+  X(Float2x2, "float2x2") \
+  X(Float3x3, "float3x3") \
+  X(Float4x4, "float4x4") \
+  X(Int, "int") \
+  X(Int2, "int2") \
+  X(Int3, "int3") \
+  X(Int4, "int4") \
+  X(Bool, "bool") \
+  X(Bool2, "bool2") \
+  X(Bool3, "bool3") \
+  X(Bool4, "bool4") \
+  X(String, "string") \
+  X(Enum, "enum") \
+  /* FX programmable profiles */ \
+  X(Pass, "pass") \
+  X(States, "states") \
+  X(Program, "program") \
+  X(Shader, "shader") \
+  X(Code, "code") \
+  X(Include, "include") \
+  X(Compiler, "compiler") \
+  X(Linker, "linker") \
+  X(Binary, "binary") \
+  X(BindAttribute, "bind_attribute") \
+  X(BindUniform, "bind_uniform") \
+  X(Evaluate, "evaluate") \
+  X(ColorTarget, "color_target") \
+  X(DepthTarget, "depth_target") \
+  X(StencilTarget, "stencil_target") \
+  X(ColorClear, "color_clear") \
+  X(DepthClear, "depth_clear") \
+  X(StencilClear, "stencil_clear") \
+  X(Draw, "draw") \
+  X(Sources, "sources") \
+  /* physics */ \
+  X(PhysicsMaterial, "physics_material") \
+  X(DynamicFriction, "dynamic_friction") \
+  X(Restitution, "restitution") \
+  X(StaticFriction, "static_friction") \
+  X(PhysicsModel, "physics_model") \
+  X(RigidBody, "rigid_body") \
+  X(RigidConstraint, "rigid_constraint") \
+  X(InstanceRigidBody, "instance_rigid_body") \
+  X(InstanceRigidConstraint, "instance_rigid_constraint") \
+  X(InstancePhysicsModel, "instance_physics_model") \
+  X(InstancePhysicsMaterial, "instance_physics_material") \
+  X(PhysicsScene, "physics_scene") \
+  X(InstanceForceField, "instance_force_field") \
+  X(ForceField, "force_field") \
+  X(Gravity, "gravity") \
+  X(TimeStep, "time_step") \
+  X(Dynamic, "dynamic") \
+  X(Mass, "mass") \
+  X(MassFrame, "mass_frame") \
+  X(Inertia, "inertia") \
+  X(Shape, "shape") \
+  X(Hollow, "hollow") \
+  X(Density, "density") \
+  X(Box, "box") \
+  X(HalfExtents, "half_extents") \
+  X(Plane, "plane") \
+  X(Equation, "equation") \
+  X(Sphere, "sphere") \
+  X(Radius, "radius") \
+  X(Cylinder, "cylinder") \
+  X(Capsule, "capsule") \
+  X(Height, "height") \
+  X(RefAttachment, "ref_attachment") \
+  X(Attachment, "attachment") \
+  X(Enabled, "enabled") \
+  X(Interpenetrate, "interpenetrate") \
+  X(Limits, "limits") \
+  X(SwingConeAndTwist, "swing_cone_and_twist") \
+  X(Linear, "linear") \
+  X(Min, "min") \
+  X(Max, "max") \
+  X(Spring, "spring") \
+  X(Angular, "angular") \
+  X(Stiffness, "stiffness") \
+  X(Damping, "damping") \
+  X(TargetValue, "target_value") \
+  X(Velocity, "velocity") \
+  X(AngularVelocity, "angular_velocity") \
+  /* kinematics */ \
+  X(ArticulatedSystem, "articulated_system") \
+  X(Kinematics, "kinematics") \
+  X(Motion, "motion") \
+  X(KinematicsModel, "kinematics_model") \
+  X(Joint, "joint") \
+  X(Prismatic, "prismatic") \
+  X(Revolute, "revolute") \
+  X(Axis, "axis") \
+  X(Link, "link") \
+  X(AttachmentFull, "attachment_full") \
+  X(AttachmentStart, "attachment_start") \
+  X(AttachmentEnd, "attachment_end") \
+  X(InstanceJoint, "instance_joint") \
+  X(InstanceKinematicsModel, "instance_kinematics_model") \
+  X(InstanceArticulatedSystem, "instance_articulated_system") \
+  X(KinematicsScene, "kinematics_scene") \
+  X(Formula, "formula") \
+  X(InstanceFormula, "instance_formula") \
+  X(Target, "target") \
+  X(TechniqueOverride, "technique_override") \
+  X(BindJointAxis, "bind_joint_axis") \
+  X(BindKinematicsModel, "bind_kinematics_model") \
+  X(Speed, "speed") \
+  X(Acceleration, "acceleration") \
+  X(Deceleration, "deceleration") \
+  X(Jerk, "jerk") \
+  X(Locked, "locked") \
+  X(Index, "index") \
+  X(FrameOrigin, "frame_origin") \
+  X(FrameTip, "frame_tip") \
+  X(FrameTcp, "frame_tcp") \
+  X(FrameObject, "frame_object") \
+  X(Value, "value") \
+
+// element names interned to integers, so that the loader can
+// switch on them instead of comparing strings
+enum class ColladaTag : uint16_t {
+
+#define COLLADA_TAG_ENUMERATOR(_id, _name) _id,
+  COLLADA_TAGS(COLLADA_TAG_ENUMERATOR)
+#undef COLLADA_TAG_ENUMERATOR
+
+  // any name outside the vocabulary
+  Unknown
+
+};
+
+// maps an element name to its tag, Unknown if it isn't a COLLADA
+// element. a perfect hash lookup: one hash over the name and one
+// string compare
+ColladaTag colladaTag(const char* _name, size_t _length);
+
+inline ColladaTag
+colladaTag(const std::string& _name){
+
+  return colladaTag(_name.data(), _name.size());
+
+}
+
+// the element name of a tag
+const char* colladaTagName(ColladaTag _tag);
+
+#endif
@@ -4,17 +4,73 @@
 #include <algorithm>
 using namespace std;
 
+/*----------------------------- XMLDocumentPool ------------------------------*/
+
+XMLDocumentPool::
+XMLDocumentPool(size_t _capacity) :
+  m_state(make_shared<State>()) {
+  m_state->capacity = _capacity;
+}
+
+shared_ptr<TiXmlDocument>
+XMLDocumentPool::
+acquire(const string& _filename) {
+  unique_ptr<TiXmlDocument> doc;
+  if(m_state->free.empty()) {
+    doc.reset(new TiXmlDocument(_filename));
+    doc->SetKeepArena(true);
+  }
+  else {
+    doc = move(m_state->free.back());
+    m_state->free.pop_back();
+    doc->SetValue(_filename);
+  }
+
+  weak_ptr<State> state = m_state;
+  return shared_ptr<TiXmlDocument>(doc.release(), [state](TiXmlDocument* _doc) {
+      shared_ptr<State> pool = state.lock();
+      if(pool && pool->free.size() < pool->capacity) {
+        // Free the tree now; the arena keeps its memory for the next load.
+        // This runs every node's destructor, linear in the tree's size.
+        _doc->Clear();
+        pool->free.emplace_back(_doc);
+      }
+      else
+        delete _doc;
+    });
+}
+
+/*--------------------------------- XMLNode ----------------------------------*/
+
 XMLNode::
 XMLNode(TiXmlNode* _node){
 
   m_node = _node;
 
+  // a lookup that found nothing hands in a null node
+  m_doc = _node ? _node->GetDocument() : nullptr;
+
 }
 
 XMLNode::
-XMLNode(const string& _filename, const string& _desiredNode) :
-    m_filename(_filename) {
-  m_doc = new TiXmlDocument(_filename);
+XMLNode(const string& _filename, const string& _desiredNode,
+    const XMLLoadOptions& _options) {
+  if(XML_ACCESS_TRACKING && _options.tracking) {
+    m_trackingStorage = make_shared<Tracking>();
+    m_tracking = m_trackingStorage.get();
+  }
+  if(_options.pool)
+    m_docStorage = _options.pool->acquire(_filename);
+  else
+    m_docStorage.reset(new TiXmlDocument(_filename));
+  m_doc = m_docStorage.get();
+  m_doc->SetMemoryMap(_options.memoryMap);
+  m_doc->SetUseArena(_options.arena);
+  m_doc->SetInterner(_options.interner);
+  m_doc->SetSkipFilter(_options.skipFilter);
+  m_doc->SetRawText(_options.rawText);
+  m_doc->SetExactLocation(_options.exactLocation);
+  m_doc->SetParallelText(_options.textThreads, _options.textThreadBytes);
 
   if(!m_doc->LoadFile())
     throw ParseException(
@@ -31,22 +87,29 @@ XMLNode(const string& _filename, const string& _desiredNode) :
 XMLNode::iterator
 XMLNode::
 begin() {
-  buildChildVector();
-  return m_children.begin();
+  return iterator(XMLNode(nextElement(m_node->FirstChild()), m_doc, m_tracking));
 }
 
 XMLNode::iterator
 XMLNode::
 end() {
-  buildChildVector();
-  return m_children.end();
+  return iterator();
+}
+
+XMLNode::iterator
+XMLNode::
+findChild(const string& _name) {
+  iterator child = begin();
+  while(child != end() && child->name() != _name)
+    ++child;
+  return child;
 }
 
 void
 XMLNode::
 verify(const std::string& _name) {
   if(_name == name())
-    m_accessed = true;
+    access();
   else
     throw ParseException(where(), "Invalid request of node '" + name() + "'.");
 }
@@ -57,8 +120,7 @@ read(const string& _name,
     bool _req,
     bool _default,
     const string& _desc) {
-  m_accessed = true;
-  m_reqAttributes.insert(_name);
+  request(_name);
   const char* attrVal =  m_node->ToElement()->Attribute(_name.c_str());
   string toReturn;
   if(attrVal == nullptr) {
@@ -85,8 +147,7 @@ read(const string& _name,
     bool _req,
     const string& _default,
     const string& _desc) {
-  m_accessed = true;
-  m_reqAttributes.insert(_name);
+  request(_name);
   const char* attrVal =  m_node->ToElement()->Attribute(_name.c_str());
   string toReturn;
   if(attrVal == NULL) {
@@ -103,41 +164,53 @@ read(const string& _name,
 void
 XMLNode::
 warnAll(bool _warningsAsErrors) {
+  if(!m_tracking)
+    throw ParseException(filename(),
+        "Access tracking is off, so there is nothing to warn about.");
   computeAccessed();
   bool anyWarnings = false;
   warnAllRec(anyWarnings);
   if(anyWarnings && _warningsAsErrors)
-    throw ParseException(m_filename, "Reported Warnings are errors.");
+    throw ParseException(filename(), "Reported Warnings are errors.");
 }
 
 string
 XMLNode::
 where() const {
-  return where(m_filename, m_node->Row(), m_node->Column());
+  return where(filename(), m_node->Row(), m_node->Column());
 }
 
-void
 XMLNode::
-buildChildVector() {
-  if(!m_childBuilt) {
-    TiXmlNode* child = m_node->FirstChild();
-    while(child != nullptr) {
-      if(child->Type() == TiXmlNode::ELEMENT)
-        m_children.push_back(XMLNode(child, m_filename, m_doc));
-      else if(child->Type() != TiXmlNode::COMMENT)
-        throw ParseException(where(m_filename, child->Row(), child->Column()),
-            "Invalid XML element.");
-      child = child->NextSibling();
-    }
-
-    m_childBuilt = true;
+XMLNode(TiXmlNode* _node, TiXmlDocument* _doc, Tracking* _tracking) :
+  m_node(_node), m_doc(_doc), m_tracking(_tracking) {
   }
-}
 
+TiXmlNode*
 XMLNode::
-XMLNode(TiXmlNode* _node, const string& _filename, TiXmlDocument* _doc) :
-  m_node(_node), m_filename(_filename), m_doc(_doc) {
+nextElement(TiXmlNode* _child) const {
+  while(_child != nullptr && _child->Type() != TiXmlNode::ELEMENT) {
+    if(_child->Type() != TiXmlNode::COMMENT)
+      throw ParseException(where(filename(), _child->Row(), _child->Column()),
+          "Invalid XML element.");
+    _child = _child->NextSibling();
   }
+  return _child;
+}
+
+bool
+XMLNode::
+accessed() const {
+  return m_tracking && m_tracking->accessed.count(m_node);
+}
+
+XMLNode::iterator&
+XMLNode::iterator::
+operator++() {
+  TiXmlNode* parent = m_child.m_node->Parent();
+  XMLNode parentNode(parent, m_child.m_doc, m_child.m_tracking);
+  m_child.m_node = parentNode.nextElement(m_child.m_node->NextSibling());
+  return *this;
+}
 
 string
 XMLNode::
@@ -157,19 +230,21 @@ attrMissing(const string& _name, const string& _desc) {
   return oss.str();
 }
 
-void
+bool
 XMLNode::
 computeAccessed() {
-  for(auto& child : *this) {
-    child.computeAccessed();
-    m_accessed = m_accessed || child.m_accessed;
-  }
+  bool anyAccessed = accessed();
+  for(auto& child : *this)
+    anyAccessed = child.computeAccessed() || anyAccessed;
+  if(anyAccessed)
+    access();
+  return anyAccessed;
 }
 
 void
 XMLNode::
 warnAllRec(bool& _anyWarnings) {
-  if(m_accessed) {
+  if(accessed()) {
     for(auto& child : *this)
       child.warnAllRec(_anyWarnings);
     if(warnUnrequestedAttributes())
@@ -186,7 +261,7 @@ XMLNode::
 warnUnknownNode() {
   cerr << "*************************************************************" << endl;
   cerr << "XML Warning:: Unknown or Unrequested Node" << endl;
-  cerr << "File:: " << m_filename << endl;
+  cerr << "File:: " << filename() << endl;
   cerr << "Node: " << name() << endl;
   cerr << "Line: " << m_node->Row() << endl;
   cerr << "Col: " << m_node->Column() << endl;
@@ -197,16 +272,17 @@ bool
 XMLNode::
 warnUnrequestedAttributes() {
   vector<string> unreqAttr;
+  const unordered_set<string>& reqAttributes = m_tracking->requested[m_node];
   const TiXmlAttribute* attr = m_node->ToElement()->FirstAttribute();
   while(attr != NULL) {
-    if(m_reqAttributes.count(attr->Name()) == 0)
+    if(reqAttributes.count(attr->Name()) == 0)
       unreqAttr.push_back(attr->Name());
     attr = attr->Next();
   }
   if(unreqAttr.size() > 0) {
     cerr << "*************************************************************" << endl;
     cerr << "XML Warning:: Unrequested Attributes Exist" << endl;
-    cerr << "File:: " << m_filename << endl;
+    cerr << "File:: " << filename() << endl;
     cerr << "Node: " << name() << endl;
     cerr << "Line: " << m_node->Row() << endl;
     cerr << "Col: " << m_node->Column() << endl;
@@ -242,6 +318,19 @@ return str;
   
 }
 
+XMLTextView
+XMLNode::
+getText() const {
+  XMLTextView text;
+  const TiXmlNode* child = m_node->FirstChild();
+  if(child && child->ToText()) {
+    const string& value = child->ValueStr();
+    text.data = value.data();
+    text.size = value.size();
+  }
+  return text;
+}
+
 TiXmlNode*
 XMLNode::
 getNextSibling(){
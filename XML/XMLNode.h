@@ -2,6 +2,9 @@
 #define _XML_NODE_H_
 
 // STL
+#include <iterator>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -11,12 +14,111 @@
 #endif
 #include "tinyxml/tinyxml.h"
 
+#include "XMLNumber.h"
+
 // mathtool
 #include <Vector.h>
 
 // Exceptions
 #include <Exceptions.h>
 
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Whether XMLNode can record accessed nodes and requested attributes
+///
+/// The record is only used by XMLNode::warnAll. Define to 0, for the library
+/// and the code using it alike, to compile the bookkeeping out of every read;
+/// XMLLoadOptions::tracking turns it off for a single document instead.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef XML_ACCESS_TRACKING
+#define XML_ACCESS_TRACKING 1
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Recycles documents across consecutive loads
+///
+/// A document handed back to the pool is emptied but keeps the memory of its
+/// arena, so the next tree loaded through XMLLoadOptions::pool is built in
+/// memory that is already mapped rather than taken from and returned to the
+/// system again. Handing a document back still empties its tree node by node,
+/// since every node's destructor must run to free its strings, so the cost of
+/// letting go grows with the tree; only the per node frees are saved.
+/// Documents may outlive the pool, they are then simply deleted.
+/// Not thread safe; give each loading thread its own pool.
+////////////////////////////////////////////////////////////////////////////////
+class XMLDocumentPool {
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @param _capacity Most documents kept for reuse
+    explicit XMLDocumentPool(size_t _capacity = 1);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @param _filename Name of the document
+    /// @return Empty document, handed back to the pool when its last owner
+    ///         lets go
+    std::shared_ptr<TiXmlDocument> acquire(const std::string& _filename);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Number of documents waiting for reuse
+    size_t size() const {return m_state->free.size();}
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Part of the pool its documents refer back to
+    struct State {
+      size_t capacity;                                   ///< Most kept
+      std::vector<std::unique_ptr<TiXmlDocument>> free;  ///< Kept documents
+    };
+
+    std::shared_ptr<State> m_state; ///< Kept documents
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Options controlling how an XML file is brought into memory
+////////////////////////////////////////////////////////////////////////////////
+struct XMLLoadOptions {
+  bool memoryMap{true};                 ///< Parse regular files in place
+                                        ///< from a private mapping
+  bool arena{true};                     ///< Allocate the tree from a
+                                        ///< per-document arena
+  TiXmlInterner interner{nullptr};      ///< Numbers element names as they are
+                                        ///< parsed
+  TiXmlSkipFilter* skipFilter{nullptr}; ///< Elements to leave out of the tree
+  bool rawText{false};                  ///< Keep entity-free text verbatim,
+                                        ///< white space included
+  XMLDocumentPool* pool{nullptr};       ///< Take the document from a pool
+                                        ///< instead of creating one
+  bool exactLocation{true};             ///< Count tabs and multi-byte
+                                        ///< characters in columns, see
+                                        ///< TiXmlDocument::SetExactLocation
+  bool tracking{true};                  ///< Record accessed nodes and
+                                        ///< requested attributes for
+                                        ///< XMLNode::warnAll
+  int textThreads{0};                   ///< Worker threads decoding long
+                                        ///< text while the tree is built
+  size_t textThreadBytes{64 * 1024};    ///< Shortest text handed to them
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Read-only view of the text of an XMLNode
+///
+/// Points into the document, so it is only valid as long as the XMLNode it came
+/// from. Not null terminated.
+////////////////////////////////////////////////////////////////////////////////
+struct XMLTextView {
+  const char* data{nullptr}; ///< First character
+  size_t size{0};            ///< Number of characters
+
+  const char* begin() const {return data;}
+  const char* end() const {return data + size;}
+  bool empty() const {return size == 0;}
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @ingroup IOUtils
 /// @brief Wrapper class for XML handeling
@@ -30,19 +132,28 @@ class XMLNode {
 
     std::string getString();
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Text of the node without copying it, empty if there is none
+    XMLTextView getText() const;
+
     TiXmlNode* getNextSibling();
 
     TiXmlNode* getFirstChild();
     
-    typedef std::vector<XMLNode>::iterator iterator; ///< Child iterator
+    class iterator; ///< Child iterator
 
     ////////////////////////////////////////////////////////////////////////////
     /// @param _filename XML Filename
     /// @param _desiredNode Desired XML Node to make root of tree
+    /// @param _options How the file is read into memory
     ///
     /// Will throw ParseException when \p _desiredNode cannot be found of
     /// \p _filename is poorly formed input
-    explicit XMLNode(const std::string& _filename, const std::string& _desiredNode);
+    ///
+    /// The document is released when this node and all copies of it are
+    /// destroyed. Nodes reached from it must not be used after that.
+    explicit XMLNode(const std::string& _filename, const std::string& _desiredNode,
+                     const XMLLoadOptions& _options = XMLLoadOptions());
 
     XMLNode(TiXmlNode* _node);
 
@@ -50,8 +161,14 @@ class XMLNode {
     /// @return Name of XMLNode
     const std::string& name() const {return m_node->ValueStr();}
     ////////////////////////////////////////////////////////////////////////////
+    /// @return Number XMLLoadOptions::interner gave the name, -1 if none
+    int nameId() const {return m_node->NameId();}
+    ////////////////////////////////////////////////////////////////////////////
     /// @return Name of XML file
-    const std::string& filename() const {return m_filename;}
+    const std::string& filename() const {return m_doc->ValueStr();}
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Counters describing how the XML file was read
+    const TiXmlLoadStats& loadStats() const {return m_doc->LoadStats();}
 
     ////////////////////////////////////////////////////////////////////////////
     /// @return Iterator to first child
@@ -60,6 +177,11 @@ class XMLNode {
     /// @return Iterator to end of children
     iterator end();
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @param _name Name of child
+    /// @return Iterator to first child named \p _name, end() if there is none
+    iterator findChild(const std::string& _name);
+
     ////////////////////////////////////////////////////////////////////////////
     /// @brief Verify XML node name and consider it accessed
     void verify(const std::string& _name);
@@ -79,6 +201,9 @@ class XMLNode {
     /// attribute is given, \p _default is returned, otherwise input value is
     /// required to be in the range [\p _min, \p _max]. Otherwise, an error is
     /// reported and \p _desc is shown to the user.
+    ///
+    /// Numbers are converted by parseAttribute, without allocating or
+    /// consulting the locale.
     template<typename T>
       T read(const std::string& _name,
              bool _req,
@@ -87,6 +212,32 @@ class XMLNode {
              const T& _max,
              const std::string& _desc);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Read XML integer attribute
+    ///
+    /// read<int>, spelled out so that literal arguments need no casts.
+    int readInt(const std::string& _name,
+                bool _req,
+                int _default,
+                int _min,
+                int _max,
+                const std::string& _desc) {
+      return read<int>(_name, _req, _default, _min, _max, _desc);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Read XML floating point attribute
+    ///
+    /// read<float>, spelled out so that literal arguments need no casts.
+    float readFloat(const std::string& _name,
+                    bool _req,
+                    float _default,
+                    float _min,
+                    float _max,
+                    const std::string& _desc) {
+      return read<float>(_name, _req, _default, _min, _max, _desc);
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     /// @brief Read XML vector attribute
     /// @tparam T Type of vector components
@@ -160,6 +311,8 @@ class XMLNode {
     /// be reported:
     ///   - unknown/unparsed nodes
     ///   - unrequested attribues
+    ///
+    /// Throws if the document was loaded without tracking.
     void warnAll(bool _warningsAsErrors = false);
 
     ////////////////////////////////////////////////////////////////////////////
@@ -172,19 +325,43 @@ class XMLNode {
 
   private:
     ////////////////////////////////////////////////////////////////////////////
-    /// @brief Generate XMLNodes for all children
+    /// @brief Which nodes and attributes of a document have been requested
     ///
-    /// Builds the internal vector of children, used when iterating over
-    /// the children. This vector is only built with ELEMENT type nodes.
-    void buildChildVector();
+    /// Kept apart from the nodes so that children can be handed out as plain
+    /// views while iterating. Shared by every node of a tree.
+    struct Tracking {
+      std::unordered_set<const TiXmlNode*> accessed; ///< Accessed nodes
+      std::unordered_map<const TiXmlNode*, std::unordered_set<std::string>>
+        requested;                                   ///< Requested attributes
+    };
 
     ////////////////////////////////////////////////////////////////////////////
-    /// @brief Private constructor for use within BuildChildVector
+    /// @brief Private constructor for use by iterator
     /// @param _node New TiXMLNode
-    /// @param _filename XML filename
     /// @param _doc TiXmlDocument from tree's root node
-    explicit XMLNode(TiXmlNode* _node, const std::string& _filename,
-                     TiXmlDocument* _doc);
+    /// @param _tracking Access record of tree's root node
+    explicit XMLNode(TiXmlNode* _node, TiXmlDocument* _doc,
+                     Tracking* _tracking);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Find the next child element
+    /// @param _child Child of this node to start from
+    /// @return First element among \p _child and its next siblings, or nullptr
+    ///
+    /// Comments are skipped, any other kind of node is an error.
+    TiXmlNode* nextElement(TiXmlNode* _child) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Consider this node accessed
+    void access();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Consider this node accessed and attribute \p _name requested
+    void request(const std::string& _name);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Has this node been accessed or not?
+    bool accessed() const;
 
     ////////////////////////////////////////////////////////////////////////////
     /// @brief Return error report for attribute being the wrong type
@@ -217,7 +394,8 @@ class XMLNode {
 
     ////////////////////////////////////////////////////////////////////////////
     /// @brief Recursive function computing whether nodes have been accessed
-    void computeAccessed();
+    /// @return Has this node or any of its descendants been accessed?
+    bool computeAccessed();
 
     ////////////////////////////////////////////////////////////////////////////
     /// @brief Recursive function reporting all unknown/unparsed nodes and
@@ -247,16 +425,77 @@ class XMLNode {
     std::string where(const std::string& _f,
                       int _l, int _c, bool _name = true) const;
 
-    TiXmlNode* m_node;          ///< TiXmlNode
-    bool m_childBuilt{false};   ///< Have children been parsed into nodes?
-    bool m_accessed{false};     ///< Has this node been accessed or not?
-    std::vector<XMLNode> m_children; ///< Children of node
-    std::unordered_set<std::string>
-      m_reqAttributes;          ///< Attributes which have been requested
-    std::string m_filename;          ///< XML Filename
-    TiXmlDocument* m_doc;       ///< Overall TiXmlDocument
+    TiXmlNode* m_node;                 ///< TiXmlNode
+    TiXmlDocument* m_doc;              ///< Overall TiXmlDocument
+    std::shared_ptr<TiXmlDocument>
+      m_docStorage;                    ///< Document owned by root node
+    Tracking* m_tracking{nullptr};     ///< Access record, null if untracked
+    std::shared_ptr<Tracking>
+      m_trackingStorage;               ///< Access record owned by root node
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Cursor over the child elements of an XMLNode
+///
+/// Follows the TinyXML sibling links, so iterating allocates nothing. The
+/// XMLNode it points to is a view reused as the cursor advances; copy it (which
+/// is cheap) to keep it past the next increment.
+////////////////////////////////////////////////////////////////////////////////
+class XMLNode::iterator {
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef XMLNode value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef XMLNode* pointer;
+    typedef XMLNode& reference;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Construct an end iterator
+    iterator() : m_child(nullptr, nullptr, nullptr) {}
+
+    XMLNode& operator*() {return m_child;}
+    XMLNode* operator->() {return &m_child;}
+
+    iterator& operator++();
+
+    bool operator==(const iterator& _other) const {
+      return m_child.m_node == _other.m_child.m_node;
+    }
+    bool operator!=(const iterator& _other) const {return !(*this == _other);}
+
+  private:
+    friend class XMLNode;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @param _child Current child element, with null node at the end
+    explicit iterator(const XMLNode& _child) : m_child(_child) {}
+
+    XMLNode m_child; ///< Current child element
+};
+
+inline
+void
+XMLNode::
+access() {
+#if XML_ACCESS_TRACKING
+  if(m_tracking)
+    m_tracking->accessed.insert(m_node);
+#endif
+}
+
+inline
+void
+XMLNode::
+request(const std::string& _name) {
+#if XML_ACCESS_TRACKING
+  if(m_tracking) {
+    m_tracking->accessed.insert(m_node);
+    m_tracking->requested[m_node].insert(_name);
+  }
+#endif
+}
+
 template<typename T>
 T
 XMLNode::
@@ -266,33 +505,22 @@ read(const std::string& _name,
      const T& _min,
      const T& _max,
      const std::string& _desc) {
-  m_accessed = true;
-  m_reqAttributes.insert(_name);
-  T toReturn;
-  int qr = m_node->ToElement()->QueryValueAttribute(_name, &toReturn);
-  switch(qr) {
-    case TIXML_WRONG_TYPE:
-      throw ParseException(where(), attrWrongType(_name, _desc));
-      break;
-    case TIXML_NO_ATTRIBUTE:
-      {
-        if(_req)
-          throw ParseException(where(), attrMissing(_name, _desc));
-        else
-          toReturn = _default;
-        break;
-      }
-    case TIXML_SUCCESS:
-      {
-        if(toReturn < _min || toReturn > _max)
-          throw ParseException(where(),
-                               attrInvalidBounds(_name, _desc, _min, _max));
-        break;
-      }
-    default:
-      throw RunTimeException(WHERE, "Logic shouldn't be able to reach this.");
+  request(_name);
+  const char* attrVal = m_node->ToElement()->Attribute(_name.c_str());
+
+  if(attrVal == nullptr) {
+    if(_req)
+      throw ParseException(where(), attrMissing(_name, _desc));
+    else
+      return _default;
   }
 
+  T toReturn{};
+  if(!parseAttribute(attrVal, toReturn))
+    throw ParseException(where(), attrWrongType(_name, _desc));
+  if(toReturn < _min || toReturn > _max)
+    throw ParseException(where(), attrInvalidBounds(_name, _desc, _min, _max));
+
   return toReturn;
 }
 
@@ -301,8 +529,7 @@ mathtool::Vector<T, D>
 XMLNode::
 read(const std::string& _name, bool _req,
      const mathtool::Vector<T, D>& _default, const std::string& _desc) {
-  m_accessed = true;
-  m_reqAttributes.insert(_name);
+  request(_name);
   mathtool::Vector<T, D> toReturn;
   const char* attrVal =  m_node->ToElement()->Attribute(_name.c_str());
 
@@ -313,10 +540,22 @@ read(const std::string& _name, bool _req,
       return _default;
   }
 
-  std::istringstream iss(attrVal);
-  if(!(iss >> toReturn))
+  // Components are separated by white space.
+  const char* p = attrVal;
+  const char* end = p + strlen(p);
+  for(size_t i = 0; i < D; ++i) {
+    while(XMLNumberDetail::isSpace(*p))
+      ++p;
+    const char* next = p;
+    while(next != end && !XMLNumberDetail::isSpace(*next))
+      ++next;
+    if(parseNumber(p, next, toReturn[i]) != next)
+      throw ParseException(where(), attrWrongType(_name, _desc));
+    p = next;
+  }
+  if(*XMLNumberDetail::skipSpace(p))
     throw ParseException(where(), attrWrongType(_name, _desc));
-  return toReturn;
+
   return toReturn;
 }
 
@@ -0,0 +1,496 @@
+#include "XMLNumber.h"
+
+// STL
+#include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <locale.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+#include <numeric>
+#include <string>
+#include <thread>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+namespace {
+
+/// Numbers up to this long are converted from a copy on the stack.
+const size_t s_shortNumber = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @return The "C" locale, whatever the global one is
+locale_t
+cLocale() {
+  static locale_t locale = newlocale(LC_ALL_MASK, "C", locale_t(0));
+  return locale;
+}
+
+void
+convert(const char* _s, char** _end, float& _value) {
+  _value = strtof_l(_s, _end, cLocale());
+}
+
+void
+convert(const char* _s, char** _end, double& _value) {
+  _value = strtod_l(_s, _end, cLocale());
+}
+
+void
+convert(const char* _s, char** _end, long double& _value) {
+  _value = strtold_l(_s, _end, cLocale());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Shared implementation of the floating point parseNumber
+///
+/// The strto*_l family needs a null terminated string and is more lenient than
+/// from_chars, so the text is copied and the extras are refused up front.
+template<typename T>
+  const char*
+  parseFloat(const char* _begin, const char* _end, T& _value) {
+    const char* p = _begin;
+    if(p != _end && *p == '-')
+      ++p;
+    // No leading white space, '+' or hexadecimal.
+    if(p == _end || !(isdigit((unsigned char)*p) || *p == '.' ||
+                      *p == 'i' || *p == 'I' || *p == 'n' || *p == 'N'))
+      return nullptr;
+    if(*p == '0' && p + 1 != _end && (p[1] == 'x' || p[1] == 'X'))
+      return nullptr;
+
+    size_t length = _end - _begin;
+    char shortCopy[s_shortNumber];
+    string longCopy;
+    const char* copy;
+    if(length < s_shortNumber) {
+      memcpy(shortCopy, _begin, length);
+      shortCopy[length] = '\0';
+      copy = shortCopy;
+    }
+    else {
+      longCopy.assign(_begin, _end);
+      copy = longCopy.c_str();
+    }
+
+    char* copyEnd;
+    errno = 0;
+    T value;
+    convert(copy, &copyEnd, value);
+    if(copyEnd == copy)
+      return nullptr;
+    // Overflow, or underflow all the way to zero. Subnormals are fine.
+    if(errno == ERANGE && (std::isinf(value) || value == 0))
+      return nullptr;
+
+    _value = value;
+    return _begin + (copyEnd - copy);
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @return True for the white space strtof skips in the "C" locale
+inline bool
+isDelimiter(char _c) {
+  return _c == ' ' || (_c >= '\t' && _c <= '\r');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @return Bit i set if byte \p _window[i] is white space or at or past
+///         \p _end, for i below 64
+uint64_t
+delimiterMask(const char* _window, const char* _end) {
+  if(_end - _window < 64) {
+    uint64_t mask = ~uint64_t(0);
+    for(int i = 0; i < _end - _window; ++i)
+      if(!isDelimiter(_window[i]))
+        mask &= ~(uint64_t(1) << i);
+    return mask;
+  }
+
+#ifdef __SSE2__
+  // '\t' to '\r' are moved to the bottom of the signed byte range so one
+  // compare finds them.
+  uint64_t mask = 0;
+  for(int i = 0; i < 64; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(_window + i));
+    __m128i control = _mm_cmplt_epi8(
+        _mm_add_epi8(v, _mm_set1_epi8(char(0x80 - '\t'))),
+        _mm_set1_epi8(char(-128 + ('\r' - '\t') + 1)));
+    __m128i blank = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    mask |= uint64_t(unsigned(_mm_movemask_epi8(_mm_or_si128(control, blank))))
+            << i;
+  }
+  return mask;
+#else
+  uint64_t mask = 0;
+  for(int i = 0; i < 64; ++i)
+    if(isDelimiter(_window[i]))
+      mask |= uint64_t(1) << i;
+  return mask;
+#endif
+}
+
+/// Powers of ten a double holds exactly.
+const double s_exactPowers[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Convert a whole token of plain decimal notation
+/// @return False if the token is anything else, or too hard to get right here
+///
+/// With at most 19 significant digits and a power of ten up to 1e22, the
+/// digits and the power are both exact doubles, so one multiplication or
+/// division gives the correctly rounded double. Rounding that to float is
+/// only wrong when it lands exactly halfway between two floats, which is
+/// refused, as are results in float's subnormal range or beyond its largest.
+bool
+convertPlain(const char* _begin, const char* _end, float& _value) {
+  const char* p = _begin;
+  bool negative = *p == '-';
+  if(negative || *p == '+')
+    ++p;
+
+  uint64_t digits = 0;
+  int significant = 0;
+  int exponent = 0;
+  bool any = false;
+  for(; p != _end && unsigned(*p - '0') < 10; ++p) {
+    any = true;
+    if(digits == 0 && *p == '0')
+      continue;
+    if(significant == 19)
+      return false;
+    digits = digits * 10 + unsigned(*p - '0');
+    ++significant;
+  }
+  if(p != _end && *p == '.') {
+    for(++p; p != _end && unsigned(*p - '0') < 10; ++p) {
+      any = true;
+      if(digits == 0 && *p == '0') {
+        --exponent;
+        continue;
+      }
+      if(significant == 19)
+        return false;
+      digits = digits * 10 + unsigned(*p - '0');
+      ++significant;
+      --exponent;
+    }
+  }
+  if(!any)
+    return false;
+
+  if(p != _end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negativeExponent = p != _end && *p == '-';
+    if(p != _end && (*p == '-' || *p == '+'))
+      ++p;
+    if(p == _end)
+      return false;
+    int written = 0;
+    for(; p != _end && unsigned(*p - '0') < 10; ++p)
+      if(written < 100000)
+        written = written * 10 + (*p - '0');
+    exponent += negativeExponent ? -written : written;
+  }
+  if(p != _end)
+    return false;
+
+  if(digits == 0) {
+    _value = negative ? -0.f : 0.f;
+    return true;
+  }
+  if(digits > (uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+    return false;
+
+  double magnitude = exponent < 0 ? double(digits) / s_exactPowers[-exponent]
+                                  : double(digits) * s_exactPowers[exponent];
+  if(magnitude < FLT_MIN || magnitude > FLT_MAX)
+    return false;
+  uint64_t bits;
+  memcpy(&bits, &magnitude, sizeof(bits));
+  const uint64_t dropped = (uint64_t(1) << 29) - 1;
+  if((bits & dropped) == (dropped + 1) / 2)
+    return false;
+
+  _value = negative ? -float(magnitude) : float(magnitude);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Convert a whole token as strtof would
+bool
+convertToken(const char* _begin, const char* _end, const char*,
+             float& _value) {
+  if(convertPlain(_begin, _end, _value))
+    return true;
+
+  size_t length = _end - _begin;
+  char shortCopy[s_shortNumber];
+  string longCopy;
+  const char* copy;
+  if(length < s_shortNumber) {
+    memcpy(shortCopy, _begin, length);
+    shortCopy[length] = '\0';
+    copy = shortCopy;
+  }
+  else {
+    longCopy.assign(_begin, _end);
+    copy = longCopy.c_str();
+  }
+
+  char* copyEnd;
+  float value;
+  convert(copy, &copyEnd, value);
+  if(size_t(copyEnd - copy) != length)
+    return false;
+  _value = value;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Convert a whole token of decimal digits
+/// @param _limit End of the readable text, at or after \p _end
+template<typename T>
+  bool
+  convertToken(const char* _begin, const char* _end, const char* _limit,
+               T& _value) {
+    // Too few digits to overflow: no need to check.
+    if(_end - _begin > numeric_limits<T>::digits10)
+      return parseNumber(_begin, _end, _value) == _end;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Up to eight digits at once, when eight bytes can be read: the token
+    // is moved to the top of a word, below it filled with '0', and the
+    // digits are combined in pairs, then fours, then eights.
+    size_t length = _end - _begin;
+    if(length <= 8 && _limit - _begin >= 8) {
+      const uint64_t zeros = 0x3030303030303030ull;
+      uint64_t word;
+      memcpy(&word, _begin, 8);
+      if(length < 8)
+        word = (word << (8 * (8 - length))) | (zeros >> (8 * length));
+      if((word & 0xf0f0f0f0f0f0f0f0ull) != zeros ||
+         ((word + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) != zeros)
+        return false;
+      word -= zeros;
+      word = (word * 10 + (word >> 8)) & 0x00ff00ff00ff00ffull;
+      word = (word * 100 + (word >> 16)) & 0x0000ffff0000ffffull;
+      word = (word * 10000 + (word >> 32)) & 0xffffffffull;
+      _value = T(word);
+      return true;
+    }
+#endif
+
+    T value = 0;
+    for(const char* p = _begin; p != _end; ++p) {
+      unsigned digit = unsigned(*p - '0');
+      if(digit > 9)
+        return false;
+      value = value * 10 + digit;
+    }
+    _value = value;
+    return true;
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Shared implementation of parseFloatArray and parseIndexArray
+template<typename T>
+  const char*
+  parseArray(const char* _begin, const char* _end, T* _out, size_t _capacity,
+             size_t& _count) {
+    _count = 0;
+
+    // Tokens are found in a window of 64 bytes at a time, from a mask of its
+    // white space. A token cut off by the end of the window moves the window
+    // to it; only a token longer than the window is measured byte by byte.
+    const char* window = _begin;
+    uint64_t delimiters = delimiterMask(window, _end);
+    const char* p = _begin;
+    while(true) {
+      uint64_t text = ~delimiters & (~uint64_t(0) << (p - window));
+      if(!text) {
+        if(_end - window <= 64)
+          return _end;
+        window += 64;
+        p = window;
+        delimiters = delimiterMask(window, _end);
+        continue;
+      }
+
+      const char* token = window + __builtin_ctzll(text);
+      uint64_t after = delimiters & (~uint64_t(0) << (token - window));
+      const char* tokenEnd;
+      if(after)
+        tokenEnd = window + __builtin_ctzll(after);
+      else if(token != window) {
+        window = p = token;
+        delimiters = delimiterMask(window, _end);
+        continue;
+      }
+      else {
+        tokenEnd = token + 64;
+        while(tokenEnd != _end && !isDelimiter(*tokenEnd))
+          ++tokenEnd;
+      }
+
+      if(_count == _capacity ||
+         !convertToken(token, tokenEnd, _end, _out[_count]))
+        return token;
+      ++_count;
+
+      p = tokenEnd;
+      if(p - window >= 64) {
+        window = p;
+        delimiters = delimiterMask(window, _end);
+      }
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @return Number of tokens parseArray would look at
+size_t
+countTokens(const char* _begin, const char* _end) {
+  // A token starts at text after white space.
+  size_t count = 0;
+  uint64_t before = 1;
+  for(const char* window = _begin; window < _end; window += 64) {
+    uint64_t delimiters = delimiterMask(window, _end);
+    count += __builtin_popcountll(~delimiters & ((delimiters << 1) | before));
+    if(_end - window <= 64)
+      break;
+    before = delimiters >> 63;
+  }
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Call \p _work with every number below \p _pieces, each on its own
+///        thread but the last, which runs on this one
+///
+/// Pieces that can't get a thread of their own run on this one too.
+template<typename Work>
+  void
+  runPieces(size_t _pieces, const Work& _work) {
+    vector<thread> threads;
+    size_t i = 0;
+    for(; i + 1 < _pieces; ++i) {
+      try {
+        threads.emplace_back([&_work, i] {_work(i);});
+      }
+      catch(...) {
+        break;
+      }
+    }
+    for(; i < _pieces; ++i)
+      _work(i);
+    for(auto& t : threads)
+      t.join();
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Shared implementation of the threaded parseFloatArray and
+///        parseIndexArray
+template<typename T>
+  const char*
+  parseArray(const char* _begin, const char* _end, NumberVector<T>& _out,
+             unsigned _threads) {
+    // Pieces end at white space, so no token is split.
+    size_t pieces = max(_threads, 1u);
+    vector<const char*> bounds(1, _begin);
+    for(size_t i = 1; i < pieces; ++i) {
+      const char* p = max(bounds.back(), _begin + (_end - _begin) / pieces * i);
+      while(p != _end && !isDelimiter(*p))
+        ++p;
+      bounds.push_back(p);
+    }
+    bounds.push_back(_end);
+
+    // Where the values of each piece go.
+    vector<size_t> offsets(pieces + 1, 0);
+    runPieces(pieces, [&](size_t _i) {
+        offsets[_i + 1] = countTokens(bounds[_i], bounds[_i + 1]);
+      });
+    partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    size_t size = _out.size();
+    // Left uninitialized: every value is converted into place below.
+    _out.resize(size + offsets.back());
+
+    vector<const char*> stops(pieces);
+    vector<size_t> counts(pieces);
+    runPieces(pieces, [&](size_t _i) {
+        stops[_i] = parseArray(bounds[_i], bounds[_i + 1],
+                               _out.data() + size + offsets[_i],
+                               offsets[_i + 1] - offsets[_i], counts[_i]);
+      });
+
+    // Nothing after the first token that isn't a number counts.
+    for(size_t i = 0; i < pieces; ++i)
+      if(counts[i] < offsets[i + 1] - offsets[i]) {
+        _out.resize(size + offsets[i] + counts[i]);
+        return stops[i];
+      }
+    return _end;
+  }
+
+}
+
+const char*
+parseNumber(const char* _begin, const char* _end, float& _value) {
+  return parseFloat(_begin, _end, _value);
+}
+
+const char*
+parseNumber(const char* _begin, const char* _end, double& _value) {
+  return parseFloat(_begin, _end, _value);
+}
+
+const char*
+parseNumber(const char* _begin, const char* _end, long double& _value) {
+  return parseFloat(_begin, _end, _value);
+}
+
+const char*
+parseFloatArray(const char* _begin, const char* _end, float* _out,
+                size_t _capacity, size_t& _count) {
+  return parseArray(_begin, _end, _out, _capacity, _count);
+}
+
+const char*
+parseIndexArray(const char* _begin, const char* _end, uint32_t* _out,
+                size_t _capacity, size_t& _count) {
+  return parseArray(_begin, _end, _out, _capacity, _count);
+}
+
+const char*
+parseIndexArray(const char* _begin, const char* _end, uint64_t* _out,
+                size_t _capacity, size_t& _count) {
+  return parseArray(_begin, _end, _out, _capacity, _count);
+}
+
+const char*
+parseFloatArray(const char* _begin, const char* _end, NumberVector<float>& _out,
+                unsigned _threads) {
+  return parseArray(_begin, _end, _out, _threads);
+}
+
+const char*
+parseIndexArray(const char* _begin, const char* _end,
+                NumberVector<uint32_t>& _out, unsigned _threads) {
+  return parseArray(_begin, _end, _out, _threads);
+}
+
+const char*
+parseIndexArray(const char* _begin, const char* _end,
+                NumberVector<uint64_t>& _out, unsigned _threads) {
+  return parseArray(_begin, _end, _out, _threads);
+}
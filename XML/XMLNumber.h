@@ -0,0 +1,217 @@
+#ifndef _XML_NUMBER_H_
+#define _XML_NUMBER_H_
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Convert the number at the start of a character range
+/// @tparam T Integer type of number
+/// @param _begin Start of text
+/// @param _end End of text
+/// @param[out] _value Converted number, untouched on failure
+/// @return One past the last character used, or nullptr if the text does not
+///         start with a number or the number does not fit in \p _value
+///
+/// Modeled on std::from_chars: no allocation, no locale, no leading white
+/// space and no '+'. A '-' is only accepted for signed types.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+  typename std::enable_if<std::is_integral<T>::value &&
+                          !std::is_same<T, bool>::value, const char*>::type
+  parseNumber(const char* _begin, const char* _end, T& _value) {
+    typedef typename std::make_unsigned<T>::type U;
+
+    const char* p = _begin;
+    bool negative = std::is_signed<T>::value && p != _end && *p == '-';
+    if(negative)
+      ++p;
+
+    U limit = U(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+    U value = 0;
+    const char* digits = p;
+    for(; p != _end && unsigned(*p - '0') < 10; ++p) {
+      U digit = U(*p - '0');
+      if(value > (limit - digit) / 10)
+        return nullptr;
+      value = value * 10 + digit;
+    }
+    if(p == digits)
+      return nullptr;
+
+    _value = T(negative ? U(0) - value : value);
+    return p;
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Floating point versions of parseNumber
+///
+/// Decimal and exponent notation as written by printf, "inf" and "nan", always
+/// with '.' as the decimal point. Correctly rounded. Values out of range fail.
+////////////////////////////////////////////////////////////////////////////////
+const char* parseNumber(const char* _begin, const char* _end, float& _value);
+const char* parseNumber(const char* _begin, const char* _end, double& _value);
+const char* parseNumber(const char* _begin, const char* _end,
+                        long double& _value);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Allocator whose vectors leave the elements a resize() adds
+///        uninitialized
+///
+/// For vectors that are resized to make room for numbers converted straight
+/// into them: zeroing the room first would write every element twice.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+  struct DefaultInitAllocator : std::allocator<T> {
+    template<typename U>
+      struct rebind {
+        typedef DefaultInitAllocator<U> other;
+      };
+
+    DefaultInitAllocator() = default;
+
+    template<typename U>
+      DefaultInitAllocator(const DefaultInitAllocator<U>&) {}
+
+    template<typename U>
+      void construct(U* _p) {
+        ::new(static_cast<void*>(_p)) U;
+      }
+
+    template<typename U, typename... Args>
+      void construct(U* _p, Args&&... _args) {
+        ::new(static_cast<void*>(_p)) U(std::forward<Args>(_args)...);
+      }
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Vector the array converters fill, see DefaultInitAllocator
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+  using NumberVector = std::vector<T, DefaultInitAllocator<T>>;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Convert a run of white space separated floats
+/// @param _begin Start of text
+/// @param _end End of text
+/// @param[out] _out Where the values go
+/// @param _capacity Room at \p _out
+/// @param[out] _count Number of values written
+/// @return Where conversion stopped: \p _end, the first token that is not a
+///         number, or the first token there was no room for
+///
+/// Built for the long arrays of a COLLADA file. Tokens are found a block of
+/// text at a time, and the common case of at most 19 significant digits and a
+/// small exponent is converted in a few instructions; anything else goes
+/// through strtof, so every token reads as strtof would read it alone, in the
+/// "C" locale. That includes "INF", "NaN", a leading '+' and values out of
+/// range, which become infinity or zero. Correctly rounded.
+////////////////////////////////////////////////////////////////////////////////
+const char* parseFloatArray(const char* _begin, const char* _end, float* _out,
+                            size_t _capacity, size_t& _count);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Index versions of parseFloatArray
+///
+/// For the index lists of a COLLADA file (<p>, <vcount>, ...): every token
+/// must be a non-negative decimal integer that fits, digits only.
+////////////////////////////////////////////////////////////////////////////////
+const char* parseIndexArray(const char* _begin, const char* _end,
+                            uint32_t* _out, size_t _capacity, size_t& _count);
+const char* parseIndexArray(const char* _begin, const char* _end,
+                            uint64_t* _out, size_t _capacity, size_t& _count);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief parseFloatArray and parseIndexArray on several threads
+/// @param _begin Start of text
+/// @param _end End of text
+/// @param[out] _out Values are appended here
+/// @param _threads Threads to use, this one included
+/// @return Where conversion stopped, as for the single threaded versions
+///
+/// The text is split at white space into a piece per thread. The tokens of
+/// every piece are counted first, so each is converted straight into its own
+/// place in \p _out. The result doesn't depend on the number of threads.
+/// Only worth it for long text; each call starts its own threads.
+////////////////////////////////////////////////////////////////////////////////
+const char* parseFloatArray(const char* _begin, const char* _end,
+                            NumberVector<float>& _out, unsigned _threads);
+const char* parseIndexArray(const char* _begin, const char* _end,
+                            NumberVector<uint32_t>& _out, unsigned _threads);
+const char* parseIndexArray(const char* _begin, const char* _end,
+                            NumberVector<uint64_t>& _out, unsigned _threads);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Convert a whole attribute value
+/// @tparam T Type of value
+/// @param _text Null terminated attribute value
+/// @param[out] _value Converted value
+/// @return True if \p _text holds exactly one value, white space around it
+///         aside
+///
+/// Numbers go through parseNumber. Other types are read with operator>>.
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+  bool
+  parseAttribute(const char* _text, T& _value);
+
+/*----------------------------------------------------------------------------*/
+
+namespace XMLNumberDetail {
+
+inline bool
+isSpace(char _c) {
+  return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\r';
+}
+
+inline const char*
+skipSpace(const char* _p) {
+  while(isSpace(*_p))
+    ++_p;
+  return _p;
+}
+
+template<typename T>
+  bool
+  parseAttribute(const char* _text, T& _value, std::true_type) {
+    const char* begin = skipSpace(_text);
+    const char* end = begin;
+    while(*end && !isSpace(*end))
+      ++end;
+    return parseNumber(begin, end, _value) == end && !*skipSpace(end);
+  }
+
+template<typename T>
+  bool
+  parseAttribute(const char* _text, T& _value, std::false_type) {
+    std::istringstream iss(_text);
+    return bool(iss >> _value);
+  }
+
+}
+
+template<typename T>
+bool
+parseAttribute(const char* _text, T& _value) {
+  return XMLNumberDetail::parseAttribute(_text, _value,
+      std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                   !std::is_same<T, bool>::value>());
+}
+
+#endif
@@ -0,0 +1,442 @@
+#include "XMLStreamParser.h"
+
+// tinyxml
+#include "tinyxml/tinyxmlgzip.h"
+
+// STL
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+
+namespace {
+
+/// Size of the pieces parseFile reads the input in.
+const size_t s_chunkSize = 1 << 20;
+
+bool
+isSpace(char _c) {
+  return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\r';
+}
+
+/// Append the UTF-8 encoding of code point \p _c to \p _out.
+void
+appendUTF8(unsigned long _c, string& _out) {
+  if(_c < 0x80)
+    _out += char(_c);
+  else if(_c < 0x800) {
+    _out += char(0xC0 | (_c >> 6));
+    _out += char(0x80 | (_c & 0x3F));
+  }
+  else if(_c < 0x10000) {
+    _out += char(0xE0 | (_c >> 12));
+    _out += char(0x80 | ((_c >> 6) & 0x3F));
+    _out += char(0x80 | (_c & 0x3F));
+  }
+  else {
+    _out += char(0xF0 | (_c >> 18));
+    _out += char(0x80 | ((_c >> 12) & 0x3F));
+    _out += char(0x80 | ((_c >> 6) & 0x3F));
+    _out += char(0x80 | (_c & 0x3F));
+  }
+}
+
+}
+
+/*-------------------------- XMLStreamAttributes -----------------------------*/
+
+const string*
+XMLStreamAttributes::
+find(const string& _name) const {
+  for(size_t i = 0; i < m_size; ++i)
+    if(m_names[i] == _name)
+      return &m_values[i];
+  return nullptr;
+}
+
+pair<string*, string*>
+XMLStreamAttributes::
+add() {
+  if(m_size == m_names.size()) {
+    m_names.emplace_back();
+    m_values.emplace_back();
+  }
+  ++m_size;
+  return make_pair(&m_names[m_size - 1], &m_values[m_size - 1]);
+}
+
+/*---------------------------- XMLStreamParser -------------------------------*/
+
+XMLStreamParser::
+XMLStreamParser(XMLStreamHandler& _handler, const string& _filename) :
+  m_handler(_handler), m_filename(_filename) {
+}
+
+void
+XMLStreamParser::
+parseFile(const string& _filename) {
+  m_filename = _filename;
+
+  FILE* file = fopen(_filename.c_str(), "rb");
+  if(!file)
+    throw ParseException(where(), "Unable to open file.");
+
+  vector<char> chunk(s_chunkSize);
+  try {
+    // The magic number is read without seeking back, so pipes work too; the
+    // bytes are handed on to whichever reads the rest.
+    unsigned char head[TiXmlGzipReader::MAGIC_SIZE];
+    size_t headLength = TiXmlGzipReader::Peek(file, head);
+
+    size_t read;
+    if(TiXmlGzipReader::IsGzip(head, headLength)) {
+      // Decompressed a chunk at a time, like plain files are read.
+      TiXmlGzipReader reader(file, head, headLength);
+      while((read = reader.Read(chunk.data(), chunk.size())) > 0)
+        feed(chunk.data(), read);
+      m_compressedBytes = reader.CompressedBytes();
+      m_decompressSeconds = reader.Seconds();
+      if(reader.Error())
+        throw ParseException(where(), "Unable to decompress file.");
+    }
+    else {
+      feed(reinterpret_cast<const char*>(head), headLength);
+      while((read = fread(chunk.data(), 1, chunk.size(), file)) > 0)
+        feed(chunk.data(), read);
+      if(ferror(file))
+        throw ParseException(where(), "Unable to read file.");
+    }
+  }
+  catch(...) {
+    fclose(file);
+    throw;
+  }
+  fclose(file);
+
+  finish();
+}
+
+void
+XMLStreamParser::
+feed(const char* _data, size_t _length) {
+  m_buffer.append(_data, _length);
+  m_bytesRead += _length;
+
+  while(m_pos < m_buffer.size()) {
+    if(m_buffer[m_pos] == '<') {
+      if(!parseMarkup())
+        break;
+    }
+    else {
+      // Character data runs up to the next markup; until that arrives the
+      // text may still continue in the next piece.
+      size_t lt = m_buffer.find('<', max(m_scan, m_pos));
+      if(lt == string::npos) {
+        m_scan = m_buffer.size();
+        break;
+      }
+      if(!m_skipDepth)
+        emitText(m_pos, lt, false);
+      advance(lt);
+    }
+  }
+
+  // Drop consumed input. Only compact once at least half the buffer is dead so
+  // that a long text node growing over many pieces isn't moved every time.
+  if(m_pos == m_buffer.size()) {
+    m_offset += m_pos;
+    m_buffer.clear();
+    m_scan = m_pos = 0;
+  }
+  else if(m_pos >= m_buffer.size() / 2) {
+    m_offset += m_pos;
+    m_buffer.erase(0, m_pos);
+    m_scan -= m_pos;
+    m_pos = 0;
+  }
+}
+
+void
+XMLStreamParser::
+finish() {
+  for(size_t i = m_pos; i < m_buffer.size(); ++i)
+    if(!isSpace(m_buffer[i]))
+      throw ParseException(where(), "Unexpected end of input.");
+  if(!m_open.empty())
+    throw ParseException(where(),
+        "Unexpected end of input inside '" + m_open.back() + "'.");
+  if(!m_rootSeen)
+    throw ParseException(where(), "Error document empty.");
+}
+
+bool
+XMLStreamParser::
+parseMarkup() {
+  const char* p = m_buffer.data() + m_pos;
+  size_t avail = m_buffer.size() - m_pos;
+  if(avail < 2)
+    return false;
+
+  size_t end;
+  if(p[1] == '!') {
+    // Comments and CDATA sections are recognized by their whole opening
+    // sequence, which may itself be split across pieces.
+    static const char comment[] = "<!--";
+    static const char cdata[] = "<![CDATA[";
+    size_t n = min(avail, sizeof(cdata) - 1);
+    if(strncmp(p, comment, min(n, sizeof(comment) - 1)) == 0) {
+      if(avail < sizeof(comment) - 1)
+        return false;
+      if((end = findTerminator("-->", m_pos + 4)) == string::npos)
+        return false;
+      advance(end + 3);
+    }
+    else if(strncmp(p, cdata, n) == 0) {
+      if(avail < sizeof(cdata) - 1)
+        return false;
+      if((end = findTerminator("]]>", m_pos + 9)) == string::npos)
+        return false;
+      if(!m_skipDepth)
+        emitText(m_pos + 9, end, true);
+      advance(end + 3);
+    }
+    else {
+      // DOCTYPE and other declarations are skipped.
+      if((end = findTerminator(">", m_pos + 2)) == string::npos)
+        return false;
+      advance(end + 1);
+    }
+  }
+  else if(p[1] == '?') {
+    if((end = findTerminator("?>", m_pos + 2)) == string::npos)
+      return false;
+    advance(end + 2);
+  }
+  else if(p[1] == '/') {
+    if((end = findTerminator(">", m_pos + 2)) == string::npos)
+      return false;
+    if(m_skipDepth)
+      skipTag(end);
+    else
+      parseEndTag(end);
+    advance(end + 1);
+  }
+  else {
+    // The '>' closing a start tag may appear inside a quoted attribute value.
+    // Tags are short, so rescanning an incomplete one on the next piece is
+    // cheaper than keeping the quote state around.
+    char quote = 0;
+    for(end = m_pos + 1; end < m_buffer.size(); ++end) {
+      char c = m_buffer[end];
+      if(quote) {
+        if(c == quote)
+          quote = 0;
+      }
+      else if(c == '"' || c == '\'')
+        quote = c;
+      else if(c == '>')
+        break;
+    }
+    if(end == m_buffer.size())
+      return false;
+    if(m_skipDepth)
+      skipTag(end);
+    else
+      parseStartTag(end);
+    advance(end + 1);
+  }
+  return true;
+}
+
+void
+XMLStreamParser::
+parseStartTag(size_t _end) {
+  const char* p = m_buffer.data() + m_pos + 1;
+  const char* end = m_buffer.data() + _end;
+
+  bool empty = end[-1] == '/';
+  if(empty)
+    --end;
+
+  const char* name = p;
+  while(p < end && !isSpace(*p) && *p != '/')
+    ++p;
+  if(p == name)
+    throw ParseException(where(), "Failed to read element name.");
+  m_name.assign(name, p);
+
+  if(m_open.empty()) {
+    if(m_rootSeen)
+      throw ParseException(where(),
+          "Element '" + m_name + "' follows the root element.");
+    m_rootSeen = true;
+  }
+  else if(m_handler.skipElement(m_name, m_open.size())) {
+    m_skipFrom = m_offset + m_pos;
+    if(empty)
+      m_bytesSkipped += _end + 1 - m_pos;
+    else
+      m_skipDepth = 1;
+    return;
+  }
+
+  m_attributes.clear();
+  while(true) {
+    while(p < end && isSpace(*p))
+      ++p;
+    if(p == end)
+      break;
+
+    const char* attrName = p;
+    while(p < end && !isSpace(*p) && *p != '=')
+      ++p;
+    const char* attrNameEnd = p;
+    while(p < end && isSpace(*p))
+      ++p;
+    if(p == end || *p != '=' || attrName == attrNameEnd)
+      throw ParseException(where(), "Error reading Attributes.");
+    ++p;
+    while(p < end && isSpace(*p))
+      ++p;
+    if(p == end || (*p != '"' && *p != '\''))
+      throw ParseException(where(), "Error reading Attributes.");
+    const char* value = ++p;
+    while(p < end && *p != value[-1])
+      ++p;
+    if(p == end)
+      throw ParseException(where(), "Error reading Attributes.");
+
+    auto attr = m_attributes.add();
+    attr.first->assign(attrName, attrNameEnd);
+    decode(value, p, *attr.second);
+    ++p;
+  }
+
+  m_handler.startElement(m_name, m_attributes);
+  if(empty)
+    m_handler.endElement(m_name);
+  else
+    m_open.push_back(m_name);
+}
+
+void
+XMLStreamParser::
+parseEndTag(size_t _end) {
+  const char* p = m_buffer.data() + m_pos + 2;
+  const char* end = m_buffer.data() + _end;
+  while(end > p && isSpace(end[-1]))
+    --end;
+
+  if(m_open.empty() || m_open.back().compare(0, string::npos, p, end - p) != 0)
+    throw ParseException(where(), "Error reading end tag.");
+
+  m_handler.endElement(m_open.back());
+  m_open.pop_back();
+}
+
+void
+XMLStreamParser::
+skipTag(size_t _end) {
+  if(m_buffer[m_pos + 1] == '/') {
+    if(--m_skipDepth == 0)
+      m_bytesSkipped += m_offset + _end + 1 - m_skipFrom;
+  }
+  else if(m_buffer[_end - 1] != '/')
+    ++m_skipDepth;
+}
+
+void
+XMLStreamParser::
+emitText(size_t _begin, size_t _end, bool _raw) {
+  if(m_open.empty())
+    return;
+
+  const char* begin = m_buffer.data() + _begin;
+  const char* end = m_buffer.data() + _end;
+  if(!_raw && all_of(begin, end, isSpace))
+    return;
+
+  if(_raw || !memchr(begin, '&', end - begin))
+    m_handler.text(begin, end - begin);
+  else {
+    decode(begin, end, m_decoded);
+    m_handler.text(m_decoded.data(), m_decoded.size());
+  }
+}
+
+size_t
+XMLStreamParser::
+findTerminator(const char* _terminator, size_t _from) {
+  size_t length = strlen(_terminator);
+  size_t pos = m_buffer.find(_terminator, max(m_scan, _from), length);
+  if(pos == string::npos && m_buffer.size() >= length)
+    // The terminator may straddle the end of this piece.
+    m_scan = max(_from, m_buffer.size() - length + 1);
+  return pos;
+}
+
+void
+XMLStreamParser::
+advance(size_t _pos) {
+  m_line += count(m_buffer.begin() + m_pos, m_buffer.begin() + _pos, '\n');
+  m_scan = m_pos = _pos;
+}
+
+void
+XMLStreamParser::
+decode(const char* _begin, const char* _end, string& _out) const {
+  static const struct {
+    const char* name;
+    size_t length;
+    char value;
+  } entities[] = {
+    {"&amp;", 5, '&'}, {"&lt;", 4, '<'}, {"&gt;", 4, '>'},
+    {"&quot;", 6, '"'}, {"&apos;", 6, '\''}
+  };
+
+  _out.clear();
+  while(_begin < _end) {
+    const char* amp = static_cast<const char*>(memchr(_begin, '&', _end - _begin));
+    if(!amp) {
+      _out.append(_begin, _end);
+      return;
+    }
+    _out.append(_begin, amp);
+    _begin = amp;
+
+    const char* semi = static_cast<const char*>(memchr(amp, ';', _end - amp));
+    if(semi && amp + 1 < semi && amp[1] == '#') {
+      bool hex = amp[2] == 'x';
+      char* digitsEnd;
+      unsigned long c = strtoul(amp + (hex ? 3 : 2), &digitsEnd, hex ? 16 : 10);
+      if(digitsEnd != semi)
+        throw ParseException(where(), "Invalid character reference.");
+      appendUTF8(c, _out);
+      _begin = semi + 1;
+      continue;
+    }
+
+    bool known = false;
+    for(const auto& e : entities) {
+      if(size_t(_end - amp) >= e.length &&
+          strncmp(amp, e.name, e.length) == 0) {
+        _out += e.value;
+        _begin = amp + e.length;
+        known = true;
+        break;
+      }
+    }
+    // Like tinyxml, pass unknown entities through unchanged.
+    if(!known)
+      _out += *_begin++;
+  }
+}
+
+string
+XMLStreamParser::
+where() const {
+  ostringstream oss;
+  oss << "File: " << m_filename;
+  oss << "\n\tLine: " << m_line;
+  return oss.str();
+}
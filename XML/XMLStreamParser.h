@@ -0,0 +1,229 @@
+#ifndef _XML_STREAM_PARSER_H_
+#define _XML_STREAM_PARSER_H_
+
+// STL
+#include <string>
+#include <vector>
+
+// Exceptions
+#include <Exceptions.h>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Attributes of an element reported by XMLStreamParser
+///
+/// Only valid for the duration of the XMLStreamHandler::startElement call they
+/// are passed to. Names and values have their entities expanded.
+////////////////////////////////////////////////////////////////////////////////
+class XMLStreamAttributes {
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Number of attributes
+    size_t size() const {return m_size;}
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Name of attribute \p _i
+    const std::string& name(size_t _i) const {return m_names[_i];}
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Value of attribute \p _i
+    const std::string& value(size_t _i) const {return m_values[_i];}
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @param _name Name of attribute
+    /// @return Value of attribute \p _name, or nullptr when it is not present
+    const std::string* find(const std::string& _name) const;
+
+  private:
+    friend class XMLStreamParser;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Forget all attributes, keeping the string storage for reuse
+    void clear() {m_size = 0;}
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Append an attribute
+    /// @return Storage for the name and value of the new attribute
+    std::pair<std::string*, std::string*> add();
+
+    size_t m_size{0};                  ///< Number of attributes in use
+    std::vector<std::string> m_names;  ///< Attribute names
+    std::vector<std::string> m_values; ///< Attribute values
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Receiver of XMLStreamParser events
+///
+/// Default implementations ignore the event.
+////////////////////////////////////////////////////////////////////////////////
+class XMLStreamHandler {
+  public:
+    virtual ~XMLStreamHandler() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief An element has been opened
+    /// @param _name Name of element
+    /// @param _attributes Attributes of element
+    virtual void startElement(const std::string& _name,
+                              const XMLStreamAttributes& _attributes) {}
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Character data inside the innermost open element
+    /// @param _text Start of the text, not null terminated
+    /// @param _length Length of the text
+    ///
+    /// Entities are expanded, white space is left untouched and whitespace-only
+    /// runs are not reported. Text interrupted by comments or CDATA sections
+    /// arrives in several calls. \p _text is only valid during the call.
+    virtual void text(const char* _text, size_t _length) {}
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief The innermost open element has been closed
+    /// @param _name Name of element
+    virtual void endElement(const std::string& _name) {}
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Decide whether to skip an element before it is opened
+    /// @param _name Name of element
+    /// @param _depth Number of open elements, 1 for children of the root
+    /// @return True to pass over the element and everything in it without
+    ///         reporting any events
+    ///
+    /// Asked about every element except the root. Skipped content is only
+    /// scanned for its end, not checked for well-formedness.
+    virtual bool skipElement(const std::string& _name, size_t _depth) {
+      return false;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @ingroup IOUtils
+/// @brief Event-driven XML parser
+///
+/// Alternative to XMLNode for documents too big to hold as a DOM. Input is
+/// pushed in arbitrarily sized pieces and reported to an XMLStreamHandler as
+/// elements open and close. Only the construct currently being read is kept in
+/// memory, so memory use is bounded by the largest single text node rather than
+/// by the size of the document.
+///
+/// Malformed input throws ParseException.
+////////////////////////////////////////////////////////////////////////////////
+class XMLStreamParser {
+  public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @param _handler Receiver of parse events
+    /// @param _filename Name of input, used in error reports
+    XMLStreamParser(XMLStreamHandler& _handler,
+                    const std::string& _filename = "");
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse an entire file, reading it in fixed size chunks
+    /// @param _filename XML Filename
+    ///
+    /// Equivalent to feeding the whole file and calling finish(). Files
+    /// starting with the gzip magic number are decompressed as they are read.
+    void parseFile(const std::string& _filename);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse the next piece of input
+    /// @param _data Input bytes
+    /// @param _length Number of input bytes
+    ///
+    /// Events for every construct completed by \p _data are delivered before
+    /// returning. Pieces may be split at any byte.
+    void feed(const char* _data, size_t _length);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Signal the end of input
+    ///
+    /// Throws ParseException if the document is empty or incomplete.
+    void finish();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Number of input bytes fed so far
+    size_t bytesRead() const {return m_bytesRead;}
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Number of input bytes in elements skipped on request of
+    ///         XMLStreamHandler::skipElement
+    size_t bytesSkipped() const {return m_bytesSkipped;}
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Size of the file given to parseFile if it is gzip compressed,
+    ///         else 0
+    size_t compressedBytes() const {return m_compressedBytes;}
+    ////////////////////////////////////////////////////////////////////////////
+    /// @return Seconds parseFile spent decompressing
+    double decompressSeconds() const {return m_decompressSeconds;}
+
+  private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse the markup starting at m_pos
+    /// @return False if the markup is not complete yet
+    bool parseMarkup();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse a start or empty-element tag
+    /// @param _end Position of the closing '>'
+    void parseStartTag(size_t _end);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse an end tag
+    /// @param _end Position of the closing '>'
+    void parseEndTag(size_t _end);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Pass over a start or end tag inside a skipped element
+    /// @param _end Position of the closing '>'
+    void skipTag(size_t _end);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Report character data to the handler
+    /// @param _begin Start of text in m_buffer
+    /// @param _end End of text in m_buffer
+    /// @param _raw True for CDATA sections, which have no entities
+    void emitText(size_t _begin, size_t _end, bool _raw);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Search for a terminator, remembering how far the search got
+    /// @param _terminator Sequence closing the current construct
+    /// @param _from Earliest position the terminator may start at
+    /// @return Position of \p _terminator, or std::string::npos
+    size_t findTerminator(const char* _terminator, size_t _from);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Consume input up to \p _pos, keeping the line count
+    void advance(size_t _pos);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Expand entities
+    /// @param _begin Start of text
+    /// @param _end End of text
+    /// @param[out] _out Expanded text
+    void decode(const char* _begin, const char* _end, std::string& _out) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief Generate string describing where parsing currently is
+    std::string where() const;
+
+    XMLStreamHandler& m_handler;      ///< Receiver of events
+    std::string m_filename;           ///< Name of input
+    std::string m_buffer;             ///< Unconsumed input
+    size_t m_pos{0};                  ///< Start of unconsumed input in m_buffer
+    size_t m_scan{0};                 ///< Resume point of terminator searches
+    size_t m_line{1};                 ///< Line number of m_pos
+    size_t m_offset{0};               ///< Input offset of m_buffer[0]
+    size_t m_skipDepth{0};            ///< Open elements being skipped
+    size_t m_skipFrom{0};             ///< Input offset of skipped element
+    size_t m_bytesRead{0};            ///< Input bytes fed
+    size_t m_bytesSkipped{0};         ///< Input bytes in skipped elements
+    size_t m_compressedBytes{0};      ///< Compressed input bytes read
+    double m_decompressSeconds{0};    ///< Time spent decompressing
+    bool m_rootSeen{false};           ///< Has the root element been opened?
+    std::vector<std::string> m_open;  ///< Names of open elements
+    std::string m_name;               ///< Scratch element name
+    std::string m_decoded;            ///< Scratch entity expansion
+    XMLStreamAttributes m_attributes; ///< Scratch attributes
+};
+
+#endif
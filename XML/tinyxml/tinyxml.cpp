@@ -23,6 +23,8 @@ distribution.
 */
 
 #include <ctype.h>
+#include <limits.h>
+#include <string.h>
 
 #ifdef TIXML_USE_STL
 #include <sstream>
@@ -30,9 +32,130 @@ distribution.
 #endif
 
 #include "tinyxml.h"
+#include "tinyxmlgzip.h"
+
+#ifdef TIXML_HAS_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 
 bool TiXmlBase::condenseWhiteSpace = true;
+thread_local TiXmlArena* TiXmlArena::active = 0;
+
+TiXmlArena::~TiXmlArena()
+{
+	FreeBlocks( blocks );
+	FreeBlocks( spare );
+}
+
+void* TiXmlArena::Alloc( size_t size )
+{
+	size = ( size + ALIGNMENT - 1 ) & ~size_t( ALIGNMENT - 1 );
+	if ( size > size_t( end - top ) )
+	{
+		// The rest of the current block is abandoned. Anything too big for
+		// a standard block gets one of its own.
+		size_t blockSize = size + ALIGNMENT;
+		if ( blockSize < BLOCK_SIZE )
+			blockSize = BLOCK_SIZE;
+
+		Block* block;
+		if ( spare && spare->size >= blockSize )
+		{
+			block = spare;
+			spare = spare->next;
+		}
+		else
+		{
+			block = (Block*) ::operator new( blockSize );
+			block->size = blockSize;
+		}
+		block->next = blocks;
+		blocks = block;
+		top = (char*) block + ALIGNMENT;
+		end = (char*) block + blockSize;
+	}
+	void* p = top;
+	top += size;
+	bytesUsed += size;
+	return p;
+}
+
+void TiXmlArena::Reset( bool keepBlocks )
+{
+	if ( keepBlocks )
+	{
+		// Pushing most recent first leaves the oldest blocks, which are of
+		// standard size, at the front of the spares.
+		while ( blocks )
+		{
+			Block* next = blocks->next;
+			blocks->next = spare;
+			spare = blocks;
+			blocks = next;
+		}
+		top = end = 0;
+		bytesUsed = 0;
+		return;
+	}
+
+	FreeBlocks( spare );
+	spare = 0;
+
+	// Keep the oldest block, which is all a small document needs.
+	Block* block = blocks;
+	while ( block && block->next )
+	{
+		Block* next = block->next;
+		::operator delete( block );
+		block = next;
+	}
+	blocks = block;
+	top = block ? (char*) block + ALIGNMENT : 0;
+	end = block ? (char*) block + block->size : 0;
+	bytesUsed = 0;
+}
+
+void TiXmlArena::FreeBlocks( Block* block )
+{
+	while ( block )
+	{
+		Block* next = block->next;
+		::operator delete( block );
+		block = next;
+	}
+}
+
+void* TiXmlBase::operator new( size_t size )
+{
+	// Each object is preceded by the arena it came from, null for the heap,
+	// so that delete knows whether there is anything to free.
+	TiXmlArena* arena = TiXmlArena::Active();
+	size += TiXmlArena::ALIGNMENT;
+	char* p = (char*) ( arena ? arena->Alloc( size ) : ::operator new( size ) );
+	*(TiXmlArena**) p = arena;
+	return p + TiXmlArena::ALIGNMENT;
+}
+
+// Once operator new is inlined, gcc sees the header handed to the global
+// operator delete as coming from the class operator new and complains.
+#if defined( __GNUC__ ) && !defined( __clang__ ) && __GNUC__ >= 11
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void TiXmlBase::operator delete( void* p )
+{
+	if ( !p )
+		return;
+	char* header = (char*) p - TiXmlArena::ALIGNMENT;
+	if ( !*(TiXmlArena**) header )
+		::operator delete( header );
+}
+#if defined( __GNUC__ ) && !defined( __clang__ ) && __GNUC__ >= 11
+#	pragma GCC diagnostic pop
+#endif
 
 // Microsoft compiler security
 FILE* TiXmlFOpen( const char* filename, const char* mode )
@@ -136,6 +259,7 @@ TiXmlNode::TiXmlNode( NodeType _type ) : TiXmlBase()
 {
 	parent = 0;
 	type = _type;
+	nameId = -1;
 	firstChild = 0;
 	lastChild = 0;
 	prev = 0;
@@ -160,6 +284,7 @@ TiXmlNode::~TiXmlNode()
 void TiXmlNode::CopyTo( TiXmlNode* target ) const
 {
 	target->SetValue (value.c_str() );
+	target->nameId = nameId;
 	target->userData = userData; 
 }
 
@@ -885,6 +1010,15 @@ TiXmlDocument::TiXmlDocument() : TiXmlNode( TiXmlNode::DOCUMENT )
 {
 	tabsize = 4;
 	useMicrosoftBOM = false;
+	memoryMap = false;
+	useArena = false;
+	interner = 0;
+	skipFilter = 0;
+	rawText = false;
+	keepArena = false;
+	parallelThreads = 0;
+	parallelMinLength = 64 * 1024;
+	exactLocation = true;
 	ClearError();
 }
 
@@ -892,6 +1026,15 @@ TiXmlDocument::TiXmlDocument( const char * documentName ) : TiXmlNode( TiXmlNode
 {
 	tabsize = 4;
 	useMicrosoftBOM = false;
+	memoryMap = false;
+	useArena = false;
+	interner = 0;
+	skipFilter = 0;
+	rawText = false;
+	keepArena = false;
+	parallelThreads = 0;
+	parallelMinLength = 64 * 1024;
+	exactLocation = true;
 	value = documentName;
 	ClearError();
 }
@@ -902,6 +1045,15 @@ TiXmlDocument::TiXmlDocument( const std::string& documentName ) : TiXmlNode( TiX
 {
 	tabsize = 4;
 	useMicrosoftBOM = false;
+	memoryMap = false;
+	useArena = false;
+	interner = 0;
+	skipFilter = 0;
+	rawText = false;
+	keepArena = false;
+	parallelThreads = 0;
+	parallelMinLength = 64 * 1024;
+	exactLocation = true;
     value = documentName;
 	ClearError();
 }
@@ -914,9 +1066,18 @@ TiXmlDocument::TiXmlDocument( const TiXmlDocument& copy ) : TiXmlNode( TiXmlNode
 }
 
 
+TiXmlDocument::~TiXmlDocument()
+{
+	// The children may live in the arena, which is destroyed before
+	// ~TiXmlNode gets to them.
+	Clear();
+}
+
+
 void TiXmlDocument::operator=( const TiXmlDocument& copy )
 {
 	Clear();
+	arena.Reset( keepArena );
 	copy.CopyTo( this );
 }
 
@@ -959,7 +1120,20 @@ bool TiXmlDocument::LoadFile( const char* _filename, TiXmlEncoding encoding )
 
 	if ( file )
 	{
-		bool result = LoadFile( file, encoding );
+		// The magic number tells gzip apart. Files that can seek are read
+		// again from the start; a pipe can't be, so the bytes peeked at are
+		// handed on.
+		unsigned char head[ TiXmlGzipReader::MAGIC_SIZE ];
+		size_t headLength = TiXmlGzipReader::Peek( file, head );
+		bool gzip = TiXmlGzipReader::IsGzip( head, headLength );
+		if ( fseek( file, 0, SEEK_SET ) == 0 )
+			headLength = 0;
+
+		bool result;
+		if ( gzip )
+			result = LoadGzipFile( file, head, headLength, encoding );
+		else if ( headLength || !memoryMap || !LoadMappedFile( file, encoding, &result ) )
+			result = LoadCopiedFile( file, (const char*) head, headLength, encoding );
 		fclose( file );
 		return result;
 	}
@@ -971,6 +1145,12 @@ bool TiXmlDocument::LoadFile( const char* _filename, TiXmlEncoding encoding )
 }
 
 bool TiXmlDocument::LoadFile( FILE* file, TiXmlEncoding encoding )
+{
+	return LoadCopiedFile( file, 0, 0, encoding );
+}
+
+
+bool TiXmlDocument::LoadCopiedFile( FILE* file, const char* head, size_t headLength, TiXmlEncoding encoding )
 {
 	if ( !file ) 
 	{
@@ -980,20 +1160,33 @@ bool TiXmlDocument::LoadFile( FILE* file, TiXmlEncoding encoding )
 
 	// Delete the existing data:
 	Clear();
+	arena.Reset( keepArena );
 	location.Clear();
+	loadStats.Clear();
 
 	// Get the file size, so we can pre-allocate the string. HUGE speed impact.
-	long length = 0;
-	fseek( file, 0, SEEK_END );
-	length = ftell( file );
-	fseek( file, 0, SEEK_SET );
+	// Pipes and terminals have no size; they are read until they run dry.
+	char* buf = 0;
+	long length = -1;
+	if ( fseek( file, 0, SEEK_END ) == 0 )
+	{
+		length = ftell( file );
+		fseek( file, 0, SEEK_SET );
+	}
+	if ( length < 0 && !ReadUnsized( file, head, headLength, &buf, &length ) )
+	{
+		SetError( TIXML_ERROR_OPENING_FILE, 0, 0, TIXML_ENCODING_UNKNOWN );
+		return false;
+	}
 
 	// Strange case, but good to handle up front.
 	if ( length <= 0 )
 	{
+		delete [] buf;
 		SetError( TIXML_ERROR_DOCUMENT_EMPTY, 0, 0, TIXML_ENCODING_UNKNOWN );
 		return false;
 	}
+	loadStats.bytesRead = length;
 
 	// If we have a file, assume it is all one big XML file, and read it in.
 	// The document parser may decide the document ends sooner than the entire file, however.
@@ -1021,13 +1214,15 @@ bool TiXmlDocument::LoadFile( FILE* file, TiXmlEncoding encoding )
 	}
 	*/
 
-	char* buf = new char[ length+1 ];
-	buf[0] = 0;
+	if ( !buf ) {
+		buf = new char[ length+1 ];
+		buf[0] = 0;
 
-	if ( fread( buf, length, 1, file ) != 1 ) {
-		delete [] buf;
-		SetError( TIXML_ERROR_OPENING_FILE, 0, 0, TIXML_ENCODING_UNKNOWN );
-		return false;
+		if ( fread( buf, length, 1, file ) != 1 ) {
+			delete [] buf;
+			SetError( TIXML_ERROR_OPENING_FILE, 0, 0, TIXML_ENCODING_UNKNOWN );
+			return false;
+		}
 	}
 
 	const char* lastPos = buf;
@@ -1085,6 +1280,158 @@ bool TiXmlDocument::LoadFile( FILE* file, TiXmlEncoding encoding )
 }
 
 
+bool TiXmlDocument::ReadUnsized( FILE* file, const char* head, size_t headLength, char** buffer, long* length )
+{
+	// Doubling the buffer keeps the copying linear in the input.
+	size_t capacity = 64 * 1024;
+	while ( capacity <= headLength )
+		capacity *= 2;
+	size_t used = headLength;
+	char* buf = new char[ capacity + 1 ];
+	if ( headLength )
+		memcpy( buf, head, headLength );
+	size_t read;
+	while ( ( read = fread( buf + used, 1, capacity - used, file ) ) > 0 )
+	{
+		used += read;
+		if ( used < capacity )
+			continue;
+		if ( capacity > (size_t) LONG_MAX / 2 )
+		{
+			delete [] buf;
+			return false;
+		}
+		char* bigger = new char[ capacity * 2 + 1 ];
+		memcpy( bigger, buf, used );
+		delete [] buf;
+		buf = bigger;
+		capacity *= 2;
+	}
+	if ( ferror( file ) )
+	{
+		delete [] buf;
+		return false;
+	}
+	*buffer = buf;
+	*length = (long) used;
+	return true;
+}
+
+
+bool TiXmlDocument::LoadMappedFile( FILE* file, TiXmlEncoding encoding, bool* result )
+{
+#ifdef TIXML_HAS_MMAP
+	// Only regular files can be mapped; pipes and devices take the copying path.
+	int fd = fileno( file );
+	struct stat info;
+	if ( fd < 0 || fstat( fd, &info ) != 0 || !S_ISREG( info.st_mode ) || info.st_size <= 0 )
+		return false;
+
+	// The parser expects a null terminated buffer. Reserve a zero filled anonymous
+	// region at least one byte longer than the file, then map the file over the
+	// front of it. Whatever follows the end of the file reads as 0.
+	size_t length = (size_t) info.st_size;
+	size_t pageSize = (size_t) sysconf( _SC_PAGESIZE );
+	size_t mapLength = ( length / pageSize + 1 ) * pageSize;
+
+	void* base = mmap( 0, mapLength, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	if ( base == MAP_FAILED )
+		return false;
+	if ( mmap( base, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0 ) == MAP_FAILED )
+	{
+		munmap( base, mapLength );
+		return false;
+	}
+	madvise( base, length, MADV_SEQUENTIAL );
+
+	// A read-only mapping can't be normalized in place (see LoadFile( FILE* )),
+	// so leave files with carriage returns to the copying path.
+	const char* buf = (const char*) base;
+	if ( memchr( buf, 0xd, length ) )
+	{
+		munmap( base, mapLength );
+		return false;
+	}
+
+	Clear();
+	arena.Reset( keepArena );
+	location.Clear();
+	loadStats.Clear();
+	loadStats.bytesRead = length;
+	loadStats.bytesNotCopied = length;
+
+	Parse( buf, 0, encoding );
+	munmap( base, mapLength );
+
+	*result = !Error();
+	return true;
+#else
+	(void) file;
+	(void) encoding;
+	(void) result;
+	return false;
+#endif
+}
+
+
+bool TiXmlDocument::LoadGzipFile( FILE* file, const unsigned char* head, size_t headLength, TiXmlEncoding encoding )
+{
+	Clear();
+	arena.Reset( keepArena );
+	location.Clear();
+	loadStats.Clear();
+
+	// The decompressed text goes straight into the buffer that is parsed,
+	// normalizing line breaks as LoadFile( FILE* ) does on the way. A CR
+	// ending one piece may be followed by the LF starting the next.
+	TIXML_STRING data;
+	if ( !headLength )
+		data.reserve( TiXmlGzipReader::SizeHint( file ) );
+
+	TiXmlGzipReader reader( file, head, headLength );
+	char piece[ TiXmlGzipReader::INPUT_SIZE ];
+	bool cr = false;
+	size_t length;
+	while ( ( length = reader.Read( piece, sizeof( piece ) ) ) > 0 )
+	{
+		const char* p = piece;
+		const char* end = piece + length;
+		if ( cr && *p == 0xa )
+			++p;
+		cr = false;
+		while ( p < end )
+		{
+			const char* q = (const char*) memchr( p, 0xd, end - p );
+			if ( !q )
+			{
+				data.append( p, end - p );
+				break;
+			}
+			data.append( p, q - p );
+			data += (char) 0xa;
+			p = q + 1;
+			if ( p == end )
+				cr = true;
+			else if ( *p == 0xa )
+				++p;
+		}
+	}
+
+	loadStats.bytesRead = reader.DecompressedBytes();
+	loadStats.compressedBytes = reader.CompressedBytes();
+	loadStats.decompressSeconds = reader.Seconds();
+
+	if ( reader.Error() )
+		SetError( TIXML_ERROR_DECOMPRESSING, 0, 0, TIXML_ENCODING_UNKNOWN );
+	else if ( data.empty() )
+		SetError( TIXML_ERROR_DOCUMENT_EMPTY, 0, 0, TIXML_ENCODING_UNKNOWN );
+	else
+		Parse( data.c_str(), 0, encoding );
+
+	return !Error();
+}
+
+
 bool TiXmlDocument::SaveFile( const char * filename ) const
 {
 	// The old c stuff lives on...
@@ -1126,6 +1473,15 @@ void TiXmlDocument::CopyTo( TiXmlDocument* target ) const
 	target->tabsize = tabsize;
 	target->errorLocation = errorLocation;
 	target->useMicrosoftBOM = useMicrosoftBOM;
+	target->memoryMap = memoryMap;
+	target->useArena = useArena;
+	target->interner = interner;
+	target->skipFilter = skipFilter;
+	target->rawText = rawText;
+	target->keepArena = keepArena;
+	target->parallelThreads = parallelThreads;
+	target->parallelMinLength = parallelMinLength;
+	target->exactLocation = exactLocation;
 
 	TiXmlNode* node = 0;
 	for ( node = firstChild; node; node = node->NextSibling() )
@@ -82,6 +82,11 @@ distribution.
 	#endif
 #endif	
 
+// Loading files in place (TiXmlDocument::SetMemoryMap) needs POSIX mmap.
+#if defined( __unix__ ) || defined( __APPLE__ )
+	#define TIXML_HAS_MMAP
+#endif
+
 class TiXmlDocument;
 class TiXmlElement;
 class TiXmlComment;
@@ -108,6 +113,110 @@ struct TiXmlCursor
 };
 
 
+/*	Counters describing how the last TiXmlDocument::LoadFile() brought
+	the file into memory. They are reset at the start of every load.
+*/
+struct TiXmlLoadStats
+{
+	TiXmlLoadStats()	{ Clear(); }
+	void Clear()		{ bytesRead = bytesNotCopied = arenaBytes = bytesSkipped = rawTextBytes = compressedBytes = parallelTextBytes = 0; decompressSeconds = 0; }
+
+	size_t bytesRead;		// Size of the input file, after decompression.
+	size_t bytesNotCopied;	// Input bytes parsed in place from a mapping rather than copied to the heap.
+	size_t arenaBytes;		// Bytes of node storage taken from the document's arena.
+	size_t bytesSkipped;	// Input bytes in elements left out by the document's skip filter.
+	size_t rawTextBytes;	// Text stored verbatim because of TiXmlDocument::SetRawText().
+	size_t compressedBytes;	// Size of the input file if it is gzip compressed, else 0.
+	double decompressSeconds;	// Time spent decompressing it.
+	size_t parallelTextBytes;	// Text decoded by worker threads because of TiXmlDocument::SetParallelText().
+};
+
+
+/*	Maps an element name to a number of the application's choosing, which is
+	stored on the element as it is parsed. See TiXmlDocument::SetInterner().
+*/
+typedef int (*TiXmlInterner)( const char* name, size_t length );
+
+
+/*	Lets an application leave whole elements out of the DOM. See
+	TiXmlDocument::SetSkipFilter().
+*/
+class TiXmlSkipFilter
+{
+public:
+	virtual ~TiXmlSkipFilter() {}
+
+	/*	Return true to skip the element called 'name' ('length' characters,
+		not null terminated). 'depth' is the number of elements it is nested
+		in, 1 for the children of the root element.
+	*/
+	virtual bool Skip( const char* name, size_t length, int depth ) = 0;
+};
+
+
+/*	Bump allocator for the nodes, attributes and text a TiXmlDocument creates
+	while it parses. Allocating is a pointer increment, freeing a single object
+	does nothing, and the memory goes back all at once with Reset() or when the
+	arena is destroyed. Objects in it are still destroyed one by one; only
+	their storage is released in bulk.
+
+	While a Scope is alive, every TiXmlBase object created with new on that
+	thread comes from its arena (see TiXmlBase::operator new).
+*/
+class TiXmlArena
+{
+public:
+	TiXmlArena() : blocks( 0 ), spare( 0 ), top( 0 ), end( 0 ), bytesUsed( 0 ) {}
+	~TiXmlArena();
+
+	// Returns storage for 'size' bytes, aligned for any object.
+	void* Alloc( size_t size );
+
+	// Forget all allocations, keeping the first block for the next parse, or
+	// every block if 'keepBlocks' is set. Only valid once every object in the
+	// arena has been destroyed.
+	void Reset( bool keepBlocks = false );
+
+	// Total bytes handed out by Alloc() since the last Reset().
+	size_t BytesUsed() const	{ return bytesUsed; }
+
+	// The arena objects are currently created in on this thread, or null.
+	static TiXmlArena* Active()	{ return active; }
+
+	// Makes an arena the active one for its lifetime.
+	class Scope
+	{
+	public:
+		Scope( TiXmlArena* arena ) : previous( active )	{ active = arena; }
+		~Scope()										{ active = previous; }
+	private:
+		TiXmlArena* previous;
+	};
+
+	enum { ALIGNMENT = 16, BLOCK_SIZE = 64 * 1024 };
+
+private:
+	TiXmlArena( const TiXmlArena& );		// not implemented.
+	void operator=( const TiXmlArena& );	// not allowed.
+
+	struct Block
+	{
+		Block* next;
+		size_t size;
+	};
+
+	void FreeBlocks( Block* block );
+
+	Block* blocks;		// Most recent block first.
+	Block* spare;		// Blocks kept by Reset( true ), reused before allocating.
+	char* top;			// Next free byte in blocks.
+	char* end;			// End of blocks.
+	size_t bytesUsed;
+
+	static thread_local TiXmlArena* active;
+};
+
+
 /**
 	If you call the Accept() method, it requires being passed a TiXmlVisitor
 	class to handle callbacks. For nodes that contain other nodes (Document, Element)
@@ -168,7 +277,19 @@ enum TiXmlEncoding
 	TIXML_ENCODING_LEGACY
 };
 
-const TiXmlEncoding TIXML_DEFAULT_ENCODING = TIXML_ENCODING_UNKNOWN;
+/*	Define TIXML_UTF8_ONLY to compile the parser for UTF-8 (and so ASCII) input
+	alone. Every document is then read as UTF-8, whatever encoding it declares
+	or is parsed with, and the code for the other encodings is left out.
+	Otherwise the per-character loops are still compiled once per encoding
+	and picked between once per call, rather than once per character.
+*/
+#ifdef TIXML_UTF8_ONLY
+	#define TIXML_IS_UTF8( encoding )	true
+	const TiXmlEncoding TIXML_DEFAULT_ENCODING = TIXML_ENCODING_UTF8;
+#else
+	#define TIXML_IS_UTF8( encoding )	( (encoding) == TIXML_ENCODING_UTF8 )
+	const TiXmlEncoding TIXML_DEFAULT_ENCODING = TIXML_ENCODING_UNKNOWN;
+#endif
 
 /** TiXmlBase is a base class for every class in TinyXml.
 	It does little except to establish that TinyXml classes
@@ -202,6 +323,12 @@ public:
 	TiXmlBase()	:	userData(0)		{}
 	virtual ~TiXmlBase()			{}
 
+	/*	Objects created while a TiXmlArena is active live in that arena and
+		deleting them only runs the destructor; all others use the heap.
+	*/
+	static void* operator new( size_t size );
+	static void operator delete( void* p );
+
 	/**	All TinyXml classes can print themselves to a filestream
 		or the string class (TiXmlString in non-STL mode, std::string
 		in STL mode.) Either or both cfile and str can be null.
@@ -238,7 +365,9 @@ public:
 		reflect changes in the document.
 
 		There is a minor performance cost to computing the row and column. Computation
-		can be disabled if TiXmlDocument::SetTabSize() is called with 0 as the value.
+		can be disabled if TiXmlDocument::SetTabSize() is called with 0 as the value,
+		or made cheaper, at the cost of exact columns, with
+		TiXmlDocument::SetExactLocation().
 
 		@sa TiXmlDocument::SetTabSize()
 	*/
@@ -281,6 +410,7 @@ public:
 		TIXML_ERROR_EMBEDDED_NULL,
 		TIXML_ERROR_PARSING_CDATA,
 		TIXML_ERROR_DOCUMENT_TOP_ONLY,
+		TIXML_ERROR_DECOMPRESSING,
 
 		TIXML_ERROR_STRING_COUNT
 	};
@@ -320,6 +450,10 @@ protected:
 									bool ignoreCase,			// whether to ignore case in the end tag
 									TiXmlEncoding encoding );	// the current encoding
 
+	// ReadText() for one encoding.
+	template< TiXmlEncoding E >
+	static const char* ReadTextAs( const char* in, TIXML_STRING* text, bool ignoreWhiteSpace, const char* endTag, bool ignoreCase );
+
 	// If an entity has been found, transform it into a character.
 	static const char* GetEntity( const char* in, char* value, int* length, TiXmlEncoding encoding );
 
@@ -328,7 +462,7 @@ protected:
 	inline static const char* GetChar( const char* p, char* _value, int* length, TiXmlEncoding encoding )
 	{
 		assert( p );
-		if ( encoding == TIXML_ENCODING_UTF8 )
+		if ( TIXML_IS_UTF8( encoding ) )
 		{
 			*length = utf8ByteTable[ *((const unsigned char*)p) ];
 			assert( *length >= 0 && *length < 5 );
@@ -369,6 +503,10 @@ protected:
 								bool ignoreCase,
 								TiXmlEncoding encoding );
 
+	// StringEqual() for one encoding.
+	template< TiXmlEncoding E >
+	static bool StringEqualAs( const char* p, const char* endTag, bool ignoreCase );
+
 	static const char* errorString[ TIXML_ERROR_STRING_COUNT ];
 
 	TiXmlCursor location;
@@ -382,7 +520,7 @@ protected:
 	static int IsAlphaNum( unsigned char anyByte, TiXmlEncoding encoding );
 	inline static int ToLower( int v, TiXmlEncoding encoding )
 	{
-		if ( encoding == TIXML_ENCODING_UTF8 )
+		if ( TIXML_IS_UTF8( encoding ) )
 		{
 			if ( v < 128 ) return tolower( v );
 			return v;
@@ -497,6 +635,13 @@ public:
 
 	const TIXML_STRING& ValueTStr() const { return value; }
 
+	/** The number the document's interner gave the name of this element when
+		it was parsed, or -1. Changing the value resets it.
+
+		@sa TiXmlDocument::SetInterner
+	*/
+	int NameId() const	{ return nameId; }
+
 	/** Changes the value of the node. Defined as:
 		@verbatim
 		Document:	filename of the xml file
@@ -506,11 +651,11 @@ public:
 		Text:		the text string
 		@endverbatim
 	*/
-	void SetValue(const char * _value) { value = _value;}
+	void SetValue(const char * _value) { value = _value; nameId = -1; }
 
     #ifdef TIXML_USE_STL
 	/// STL std::string form.
-	void SetValue( const std::string& _value )	{ value = _value; }
+	void SetValue( const std::string& _value )	{ value = _value; nameId = -1; }
 	#endif
 
 	/// Delete all the children of this node. Does not affect 'this'.
@@ -760,6 +905,7 @@ protected:
 	TiXmlNode*		lastChild;
 
 	TIXML_STRING	value;
+	int				nameId;
 
 	TiXmlNode*		prev;
 	TiXmlNode*		next;
@@ -1143,6 +1289,13 @@ protected:
 	*/
 	const char* ReadValue( const char* in, TiXmlParsingData* prevData, TiXmlEncoding encoding );
 
+	/*	[internal use]
+		If the element starting at 'in' is one the document's skip filter
+		rejects, moves 'in' past its end tag (null if there is none) and
+		returns true.
+	*/
+	static bool SkipElement( const char*& in, TiXmlParsingData* data );
+
 private:
 
 	TiXmlAttributeSet attributeSet;
@@ -1204,6 +1357,7 @@ private:
 class TiXmlText : public TiXmlNode
 {
 	friend class TiXmlElement;
+	friend class TiXmlTextWorkers;
 public:
 	/** Constructor for text element. By default, it is treated as 
 		normal, encoded text. If you want it be output as a CDATA text
@@ -1257,6 +1411,12 @@ protected :
 	#endif
 
 private:
+	// Decode the text from 'p' up to 'end', the '<' after it, as Parse()
+	// would. Run by the worker threads of TiXmlDocument::SetParallelText().
+	// Returns false if Parse() would have failed or read past 'end'.
+	static bool DecodeText( const char* p, const char* end, bool raw, TiXmlEncoding encoding,
+							TIXML_STRING* text, size_t* rawTextBytes );
+
 	bool cdata;			// true if this should be input and output as a CDATA style text element
 };
 
@@ -1398,7 +1558,7 @@ public:
 	TiXmlDocument( const TiXmlDocument& copy );
 	void operator=( const TiXmlDocument& copy );
 
-	virtual ~TiXmlDocument() {}
+	virtual ~TiXmlDocument();
 
 	/** Load a file using the current document value.
 		Returns true if successful. Will delete any existing
@@ -1407,19 +1567,133 @@ public:
 	bool LoadFile( TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
 	/// Save a file using the current document value. Returns true if successful.
 	bool SaveFile() const;
-	/// Load a file using the given filename. Returns true if successful.
+	/** Load a file using the given filename. Returns true if successful.
+		Files starting with the gzip magic number are decompressed as they
+		are read.
+	*/
 	bool LoadFile( const char * filename, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
 	/// Save a file using the given filename. Returns true if successful.
 	bool SaveFile( const char * filename ) const;
 	/** Load a file using the given FILE*. Returns true if successful. Note that this method
 		doesn't stream - the entire object pointed at by the FILE*
 		will be interpreted as an XML file. TinyXML doesn't stream in XML from the current
-		file location. Streaming may be added in the future.
+		file location. Streaming may be added in the future. Input that can't seek,
+		like a pipe, is read from where it is up to its end instead.
 	*/
 	bool LoadFile( FILE*, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING );
 	/// Save a file using the given FILE*. Returns true if successful.
 	bool SaveFile( FILE* ) const;
 
+	/** SetMemoryMap() makes LoadFile( filename ) parse regular files in place,
+		from a read-only private mapping, instead of reading them into a heap
+		buffer and copying them again while normalizing line endings. Pipes,
+		devices and files containing carriage returns are still read the usual
+		way. Off by default.
+
+		@sa LoadStats
+	*/
+	void SetMemoryMap( bool _memoryMap )	{ memoryMap = _memoryMap; }
+	/// Return the current memory map setting.
+	bool MemoryMap() const					{ return memoryMap; }
+
+	/** SetUseArena() makes Parse() allocate the nodes, attributes and text it
+		creates from an arena owned by the document, so building the tree is a
+		series of pointer bumps and tearing it down frees a handful of blocks
+		instead of every node. Teardown is still linear in the number of nodes:
+		every node's destructor runs, to free the names and values it holds
+		outside the arena. Nodes parsed this way must not outlive the document.
+		Off by default.
+
+		@sa LoadStats
+	*/
+	void SetUseArena( bool _useArena )		{ useArena = _useArena; }
+	/// Return the current arena setting.
+	bool UseArena() const					{ return useArena; }
+
+	/** SetInterner() makes Parse() pass every element name to 'interner' and
+		keep the result on the element, available from TiXmlNode::NameId(),
+		so that an application can dispatch on numbers instead of comparing
+		names. Null, the default, leaves NameId() at -1.
+	*/
+	void SetInterner( TiXmlInterner _interner )	{ interner = _interner; }
+	/// Return the current interner.
+	TiXmlInterner Interner() const				{ return interner; }
+
+	/** SetSkipFilter() makes Parse() ask 'filter' about every element below the
+		root element before parsing it. Elements the filter skips are passed
+		over by scanning for their end tag: no nodes are created for them or
+		anything inside them, and their content is not checked for errors.
+		The filter is not owned by the document. Null, the default, parses
+		everything.
+
+		@sa LoadStats
+	*/
+	void SetSkipFilter( TiXmlSkipFilter* _skipFilter )	{ skipFilter = _skipFilter; }
+	/// Return the current skip filter.
+	TiXmlSkipFilter* SkipFilter() const					{ return skipFilter; }
+
+	/** SetRawText() makes Parse() store text that holds no entities exactly as
+		it appears in the input, with a single copy, instead of decoding and
+		condensing it a character at a time. White space inside and after
+		such text is kept whatever IsWhiteSpaceCondensed() says. Text with an
+		'&' in it is read as usual. Off by default.
+
+		@sa LoadStats
+	*/
+	void SetRawText( bool _rawText )		{ rawText = _rawText; }
+	/// Return the current raw text setting.
+	bool RawText() const					{ return rawText; }
+
+	/** SetKeepArena() makes loading a new file keep all the memory the arena
+		took for the previous tree and build the new tree in it, instead of
+		handing all but one block back to the heap. Meant for documents that
+		are reused for many files in a row. Off by default.
+
+		@sa SetUseArena
+	*/
+	void SetKeepArena( bool _keepArena )	{ keepArena = _keepArena; }
+	/// Return the current keep arena setting.
+	bool KeepArena() const					{ return keepArena; }
+
+	/** SetParallelText() splits parsing in two stages. The first indexes
+		where every '<' of the input is, 64 bytes at a time. The second builds
+		the tree as usual on the calling thread, but steps straight over any
+		text of at least 'minLength' bytes, handing it to one of 'threads'
+		worker threads to decode. Parse() waits for them before returning, so
+		the tree comes out exactly as without it. Meant for documents with
+		large payloads in text, like long arrays of numbers. A 'threads' of
+		0, the default, turns it off.
+
+		Should text decoded by a worker be malformed, which is only found
+		once the rest of the document is parsed, the document is parsed again
+		without workers to report the error.
+
+		@sa LoadStats
+	*/
+	void SetParallelText( int threads, size_t minLength = 64 * 1024 )	{ parallelThreads = threads; parallelMinLength = minLength; }
+	/// Return the number of worker threads decoding text.
+	int ParallelTextThreads() const					{ return parallelThreads; }
+	/// Return the length of the shortest text handed to them.
+	size_t ParallelTextMinLength() const			{ return parallelMinLength; }
+
+	/** SetExactLocation( false ) makes Parse() keep track of the row and
+		column of every node cheaply: it only looks for line breaks, with
+		memchr(), and counts every byte after the last one as a column. Rows
+		stay exact for input with '\n' line breaks, as loaded files always
+		are; columns count tab characters as one and multi-byte characters as
+		several. The location of a parse error, ErrorRow() and ErrorCol(), is
+		exact regardless, as it is worked out again from the start of the
+		input when an error is found. On by default.
+
+		@sa SetTabSize
+	*/
+	void SetExactLocation( bool _exactLocation )	{ exactLocation = _exactLocation; }
+	/// Return the current exact location setting.
+	bool ExactLocation() const						{ return exactLocation; }
+
+	/// Counters describing how the last LoadFile() read its input.
+	const TiXmlLoadStats& LoadStats() const	{ return loadStats; }
+
 	#ifdef TIXML_USE_STL
 	bool LoadFile( const std::string& filename, TiXmlEncoding encoding = TIXML_DEFAULT_ENCODING )			///< STL std::string version.
 	{
@@ -1542,12 +1816,41 @@ protected :
 private:
 	void CopyTo( TiXmlDocument* target ) const;
 
+	// Parse the file behind 'file' from a memory mapping. Returns false, without
+	// touching the document, if the file can not be parsed in place; otherwise
+	// returns true and stores the outcome of the parse in 'result'.
+	bool LoadMappedFile( FILE* file, TiXmlEncoding encoding, bool* result );
+
+	// Read 'file' up to its end into a new[] buffer with room for a null after
+	// the 'length' bytes read, for input that can't tell its size up front.
+	// The 'headLength' bytes at 'head' go first. Returns false on a read error.
+	static bool ReadUnsized( FILE* file, const char* head, size_t headLength, char** buffer, long* length );
+
+	// Parse the gzip compressed file behind 'file' while decompressing it. The
+	// 'headLength' bytes at 'head' were already read from it and come first.
+	bool LoadGzipFile( FILE* file, const unsigned char* head, size_t headLength, TiXmlEncoding encoding );
+
+	// LoadFile( FILE* ), with 'headLength' bytes already read from a file that
+	// can't seek coming first.
+	bool LoadCopiedFile( FILE* file, const char* head, size_t headLength, TiXmlEncoding encoding );
+
 	bool error;
 	int  errorId;
 	TIXML_STRING errorDesc;
 	int tabsize;
 	TiXmlCursor errorLocation;
 	bool useMicrosoftBOM;		// the UTF-8 BOM were found when read. Note this, and try to write.
+	bool memoryMap;
+	bool useArena;
+	TiXmlInterner interner;
+	TiXmlSkipFilter* skipFilter;
+	bool rawText;
+	bool keepArena;
+	int parallelThreads;
+	size_t parallelMinLength;
+	bool exactLocation;
+	TiXmlLoadStats loadStats;
+	TiXmlArena arena;
 };
 
 
@@ -0,0 +1,150 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+#include <string.h>
+#include <chrono>
+
+#include "tinyxmlgzip.h"
+
+
+TiXmlGzipReader::TiXmlGzipReader( FILE* _file, const unsigned char* head, size_t headLength )
+{
+	file = _file;
+	input = new unsigned char[ INPUT_SIZE ];
+	memberEnded = false;
+	done = false;
+	error = false;
+	compressedBytes = 0;
+	decompressedBytes = 0;
+	seconds = 0;
+
+	memset( &stream, 0, sizeof( stream ) );
+	// 16 added to the window bits asks for a gzip wrapper rather than zlib's.
+	if ( inflateInit2( &stream, 15 + 16 ) != Z_OK )
+		error = true;
+
+	if ( headLength > INPUT_SIZE )
+		headLength = INPUT_SIZE;
+	memcpy( input, head, headLength );
+	compressedBytes = headLength;
+	stream.next_in = input;
+	stream.avail_in = (uInt) headLength;
+}
+
+
+TiXmlGzipReader::~TiXmlGzipReader()
+{
+	inflateEnd( &stream );
+	delete [] input;
+}
+
+
+size_t TiXmlGzipReader::Peek( FILE* file, unsigned char* head )
+{
+	return fread( head, 1, MAGIC_SIZE, file );
+}
+
+
+bool TiXmlGzipReader::IsGzip( const unsigned char* head, size_t length )
+{
+	return length == MAGIC_SIZE && head[0] == 0x1f && head[1] == 0x8b;
+}
+
+
+size_t TiXmlGzipReader::SizeHint( FILE* file )
+{
+	long position = ftell( file );
+	if ( position < 0 )
+		return 0;
+
+	size_t size = 0;
+	unsigned char trailer[4];
+	if (    fseek( file, 0, SEEK_END ) == 0
+		 && ftell( file ) >= position + 18			// smallest gzip member
+		 && fseek( file, -4, SEEK_END ) == 0
+		 && fread( trailer, 1, 4, file ) == 4 )
+	{
+		size = trailer[0] | ( trailer[1] << 8 ) | ( trailer[2] << 16 ) | ( (size_t) trailer[3] << 24 );
+
+		// Deflate can't do better than about 1:1032, so anything beyond that
+		// is a damaged trailer rather than something to reserve memory for.
+		long compressed = ftell( file ) - position;
+		if ( size > (size_t) compressed * 1032 )
+			size = 0;
+	}
+	fseek( file, position, SEEK_SET );
+	return size;
+}
+
+
+size_t TiXmlGzipReader::Read( char* buffer, size_t size )
+{
+	if ( done || error )
+		return 0;
+
+	stream.next_out = (Bytef*) buffer;
+	stream.avail_out = (uInt) size;
+	while ( stream.avail_out > 0 )
+	{
+		if ( stream.avail_in == 0 )
+		{
+			size_t length = fread( input, 1, INPUT_SIZE, file );
+			if ( length == 0 )
+			{
+				// Input may only run out between members.
+				if ( ferror( file ) || !memberEnded )
+					error = true;
+				else
+					done = true;
+				break;
+			}
+			compressedBytes += length;
+			stream.next_in = input;
+			stream.avail_in = (uInt) length;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		int status = inflate( &stream, Z_NO_FLUSH );
+		seconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+		if ( status == Z_STREAM_END )
+		{
+			// Another member may follow.
+			memberEnded = true;
+			inflateReset( &stream );
+		}
+		else if ( status == Z_OK || status == Z_BUF_ERROR )
+		{
+			memberEnded = false;
+		}
+		else
+		{
+			error = true;
+			break;
+		}
+	}
+
+	size_t written = size - stream.avail_out;
+	decompressedBytes += written;
+	return error ? 0 : written;
+}
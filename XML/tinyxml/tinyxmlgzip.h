@@ -0,0 +1,89 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+#ifndef TIXML_GZIP_INCLUDED
+#define TIXML_GZIP_INCLUDED
+
+#include <stdio.h>
+#include <zlib.h>
+
+/*	Decompresses a gzip file a piece at a time, so that it can be parsed
+	without ever holding the compressed file, or a decompressed copy besides
+	the parser's own, in memory. Concatenated gzip members are read as one
+	stream, like gunzip does.
+*/
+class TiXmlGzipReader
+{
+public:
+	// Reads from the current position of 'file', which stays the caller's.
+	// The 'headLength' bytes at 'head' were already read from it, by Peek(),
+	// and come first.
+	TiXmlGzipReader( FILE* file, const unsigned char* head = 0, size_t headLength = 0 );
+	~TiXmlGzipReader();
+
+	enum { MAGIC_SIZE = 2 };
+
+	// Reads the first MAGIC_SIZE bytes of 'file' into 'head', without seeking,
+	// so that pipes can be peeked at too. Returns how many there were. The
+	// caller passes them on to whatever reads the rest.
+	static size_t Peek( FILE* file, unsigned char* head );
+
+	// True if the 'length' bytes Peek() read are the gzip magic number.
+	static bool IsGzip( const unsigned char* head, size_t length );
+
+	// The decompressed size recorded at the end of 'file', or 0 if there is
+	// none. Only a hint: it is modulo 4 GiB and covers just the last member.
+	// The file position is left where it was. Input that can't be rewound,
+	// like a pipe, isn't touched and gives 0.
+	static size_t SizeHint( FILE* file );
+
+	// Decompresses up to 'size' bytes into 'buffer'. Returns the number of
+	// bytes written, which is 0 only at the end of the data or on an error.
+	size_t Read( char* buffer, size_t size );
+
+	// True if the file could not be read or is not valid gzip data.
+	bool Error() const						{ return error; }
+
+	size_t CompressedBytes() const			{ return compressedBytes; }
+	size_t DecompressedBytes() const		{ return decompressedBytes; }
+	// Time spent in inflate, in seconds.
+	double Seconds() const					{ return seconds; }
+
+	enum { INPUT_SIZE = 64 * 1024 };
+
+private:
+	TiXmlGzipReader( const TiXmlGzipReader& );	// not implemented.
+	void operator=( const TiXmlGzipReader& );	// not allowed.
+
+	FILE* file;
+	z_stream stream;
+	unsigned char* input;
+	bool memberEnded;		// The last inflate finished a gzip member.
+	bool done;
+	bool error;
+	size_t compressedBytes;
+	size_t decompressedBytes;
+	double seconds;
+};
+
+#endif
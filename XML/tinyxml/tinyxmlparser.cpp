@@ -24,8 +24,14 @@ distribution.
 
 #include <ctype.h>
 #include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "tinyxml.h"
+#include "tinyxmlscan.h"
 
 //#define DEBUG_PARSER
 #if defined( DEBUG_PARSER )
@@ -168,14 +174,157 @@ void TiXmlBase::ConvertUTF32ToUTF8( unsigned long input, char* output, int* leng
 }
 
 
+/*	The worker threads of TiXmlDocument::SetParallelText(). Parse() hands
+	them long text with Add() and steps over it; Finish() waits for all of it
+	to be decoded and gives it to its nodes.
+*/
+class TiXmlTextWorkers
+{
+  public:
+	TiXmlTextWorkers( int threads );
+	~TiXmlTextWorkers()		{ Finish(); }
+
+	void Add( TiXmlText* node, const char* p, const char* end, bool raw, TiXmlEncoding encoding );
+
+	// Returns false if any of the text failed to decode.
+	bool Finish();
+
+	size_t RawTextBytes() const	{ return rawTextBytes; }
+
+  private:
+	struct Job
+	{
+		TiXmlText* node;
+		const char* p;
+		const char* end;
+		bool raw;
+		TiXmlEncoding encoding;
+		TIXML_STRING text;
+		size_t rawTextBytes;
+		bool ok;
+	};
+
+	// Decode jobs until there are none left and no more are coming.
+	void Run();
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque< Job > jobs;		// a deque, so jobs stay put as more are added
+	size_t next;				// first job not taken yet
+	bool closing;
+	bool finished;
+	std::vector< std::thread > threads;
+	size_t rawTextBytes;
+};
+
+
+TiXmlTextWorkers::TiXmlTextWorkers( int count )
+{
+	next = 0;
+	closing = false;
+	finished = false;
+	rawTextBytes = 0;
+	for ( int i = 0; i < count; ++i )
+	{
+		// Without threads Finish() decodes everything itself.
+		try { threads.push_back( std::thread( &TiXmlTextWorkers::Run, this ) ); }
+		catch ( ... ) { break; }
+	}
+}
+
+
+void TiXmlTextWorkers::Add( TiXmlText* node, const char* p, const char* end, bool raw, TiXmlEncoding encoding )
+{
+	Job job;
+	job.node = node;
+	job.p = p;
+	job.end = end;
+	job.raw = raw;
+	job.encoding = encoding;
+	job.rawTextBytes = 0;
+	job.ok = false;
+	{
+		std::lock_guard< std::mutex > lock( mutex );
+		jobs.push_back( job );
+	}
+	wake.notify_one();
+}
+
+
+void TiXmlTextWorkers::Run()
+{
+	std::unique_lock< std::mutex > lock( mutex );
+	for ( ;; )
+	{
+		while ( next == jobs.size() && !closing )
+			wake.wait( lock );
+		if ( next == jobs.size() )
+			return;
+
+		Job& job = jobs[ next++ ];
+		lock.unlock();
+		job.ok = TiXmlText::DecodeText( job.p, job.end, job.raw, job.encoding, &job.text, &job.rawTextBytes );
+		lock.lock();
+	}
+}
+
+
+bool TiXmlTextWorkers::Finish()
+{
+	if ( finished )
+		return true;
+	finished = true;
+
+	{
+		std::lock_guard< std::mutex > lock( mutex );
+		closing = true;
+	}
+	wake.notify_all();
+
+	// Lend a hand with what is left, then wait for the rest.
+	Run();
+	for ( size_t i = 0; i < threads.size(); ++i )
+		threads[i].join();
+
+	bool ok = true;
+	for ( size_t i = 0; i < jobs.size(); ++i )
+	{
+		jobs[i].node->value.swap( jobs[i].text );
+		rawTextBytes += jobs[i].rawTextBytes;
+		ok = ok && jobs[i].ok;
+	}
+	return ok;
+}
+
+
 class TiXmlParsingData
 {
 	friend class TiXmlDocument;
   public:
 	void Stamp( const char* now, TiXmlEncoding encoding );
+	// The exact location of 'now', even without exactLocation. For errors.
+	void Locate( const char* now, TiXmlEncoding encoding );
+	// Stamp() for 'now' at the end of 'span' of the text index.
+	void StampSpan( const char* now, const TiXmlTextSpan& span, TiXmlEncoding encoding );
+	// The span of the text index 'p' is in, if there is one. Calls must
+	// move forward through the input.
+	const TiXmlTextSpan* FindSpan( const char* p );
 
 	const TiXmlCursor& Cursor()	{ return cursor; }
 
+	TiXmlInterner	interner;	// The document's interner, for element names.
+	TiXmlSkipFilter* skipFilter;	// The document's skip filter.
+	int				depth;		// Number of elements being read.
+	size_t			bytesSkipped;	// Input passed over on behalf of skipFilter.
+	bool			rawText;	// Store entity-free text verbatim.
+	size_t			rawTextBytes;	// Text stored verbatim.
+	TiXmlTextWorkers* workers;	// Decode long text, if parsing in parallel.
+	size_t			parallelMinLength;	// Shortest text to hand them.
+	size_t			parallelTextBytes;	// Text handed to them.
+	bool			textDeferred;	// The last text parsed was handed to them.
+	const char*		base;		// Where parsing started; what the text index counts from.
+	bool			exactLocation;	// Stamp() follows tabs and multi-byte characters.
+
   private:
 	// Only used by the document!
 	TiXmlParsingData( const char* start, int _tabsize, int row, int col )
@@ -185,14 +334,111 @@ class TiXmlParsingData
 		tabsize = _tabsize;
 		cursor.row = row;
 		cursor.col = col;
-	}
+		interner = 0;
+		skipFilter = 0;
+		depth = 0;
+		bytesSkipped = 0;
+		rawText = false;
+		rawTextBytes = 0;
+		workers = 0;
+		parallelMinLength = 0;
+		parallelTextBytes = 0;
+		textDeferred = false;
+		base = start;
+		exactLocation = true;
+		startCursor = cursor;
+		textIndex = 0;
+		nextSpan = 0;
+	}
+
+	// Stamp() without exactLocation.
+	void StampLines( const char* now );
+	// Stamp() with exactLocation, for one encoding.
+	template< TiXmlEncoding E > void StampAs( const char* now );
 
 	TiXmlCursor		cursor;
 	const char*		stamp;
 	int				tabsize;
+	TiXmlCursor		startCursor;	// Location of base.
+	const TiXmlTextIndex* textIndex;
+	size_t			nextSpan;	// First span FindSpan() may return.
 };
 
 
+void TiXmlParsingData::StampSpan( const char* now, const TiXmlTextSpan& span, TiXmlEncoding encoding )
+{
+	// Stamp() would walk the whole span; the index already counted what it
+	// would find, if the span is plain ASCII without tabs or carriage
+	// returns. The stamp is somewhere in the span.
+	if ( tabsize < 1 || !exactLocation || span.special || textIndex->carriageReturn )
+	{
+		Stamp( now, encoding );
+		return;
+	}
+
+	const char* lastNewline = base + span.lastNewline;
+	if ( span.newlines && lastNewline >= stamp )
+	{
+		// Skip to the last line, less the lines before the stamp.
+		size_t before = 0;
+		for ( const char* q = base + span.start; ( q = (const char*) memchr( q, '\n', stamp - q ) ) != 0; ++q )
+			++before;
+		cursor.row += (int) ( span.newlines - before );
+		cursor.col = 0;
+		stamp = lastNewline + 1;
+	}
+
+	cursor.col += (int) ( now - stamp );
+	stamp = now;
+}
+
+
+void TiXmlParsingData::StampLines( const char* now )
+{
+	// Only count the lines, a memchr() at a time, and take every byte
+	// after the last one for a column.
+	if ( now <= stamp )
+		return;
+
+	const char* lineStart = 0;
+	for ( const char* q = stamp; ( q = (const char*) memchr( q, '\n', now - q ) ) != 0; lineStart = ++q )
+		++cursor.row;
+	if ( lineStart )
+		cursor.col = (int) ( now - lineStart );
+	else
+		cursor.col += (int) ( now - stamp );
+	stamp = now;
+}
+
+
+void TiXmlParsingData::Locate( const char* now, TiXmlEncoding encoding )
+{
+	// The cursor may be off by a few columns; walk again from the start.
+	if ( !exactLocation )
+	{
+		exactLocation = true;
+		cursor = startCursor;
+		stamp = base;
+	}
+	Stamp( now, encoding );
+}
+
+
+const TiXmlTextSpan* TiXmlParsingData::FindSpan( const char* p )
+{
+	if ( !textIndex )
+		return 0;
+
+	size_t offset = p - base;
+	const std::vector< TiXmlTextSpan >& spans = textIndex->spans;
+	while ( nextSpan < spans.size() && spans[ nextSpan ].end <= offset )
+		++nextSpan;
+	if ( nextSpan < spans.size() && spans[ nextSpan ].start <= offset )
+		return &spans[ nextSpan ];
+	return 0;
+}
+
+
 void TiXmlParsingData::Stamp( const char* now, TiXmlEncoding encoding )
 {
 	assert( now );
@@ -203,6 +449,22 @@ void TiXmlParsingData::Stamp( const char* now, TiXmlEncoding encoding )
 		return;
 	}
 
+	if ( !exactLocation )
+	{
+		StampLines( now );
+		return;
+	}
+
+	if ( TIXML_IS_UTF8( encoding ) )
+		StampAs< TIXML_ENCODING_UTF8 >( now );
+	else
+		StampAs< TIXML_ENCODING_LEGACY >( now );
+}
+
+
+template< TiXmlEncoding E >
+void TiXmlParsingData::StampAs( const char* now )
+{
 	// Get the current row, column.
 	int row = cursor.row;
 	int col = cursor.col;
@@ -211,6 +473,13 @@ void TiXmlParsingData::Stamp( const char* now, TiXmlEncoding encoding )
 
 	while ( p < now )
 	{
+		// Most bytes are a column each; count those a run at a time.
+		const char* run = TiXmlScanColumns( p, now );
+		col += (int)( run - p );
+		p = run;
+		if ( p == now )
+			break;
+
 		// Treat p as unsigned, so we have a happy compiler.
 		const unsigned char* pU = (const unsigned char*)p;
 
@@ -259,7 +528,7 @@ void TiXmlParsingData::Stamp( const char* now, TiXmlEncoding encoding )
 				break;
 
 			case TIXML_UTF_LEAD_0:
-				if ( encoding == TIXML_ENCODING_UTF8 )
+				if ( E == TIXML_ENCODING_UTF8 )
 				{
 					if ( *(p+1) && *(p+2) )
 					{
@@ -283,7 +552,7 @@ void TiXmlParsingData::Stamp( const char* now, TiXmlEncoding encoding )
 				break;
 
 			default:
-				if ( encoding == TIXML_ENCODING_UTF8 )
+				if ( E == TIXML_ENCODING_UTF8 )
 				{
 					// Eat the 1 to 4 byte utf8 character.
 					int step = TiXmlBase::utf8ByteTable[*((const unsigned char*)p)];
@@ -317,7 +586,7 @@ const char* TiXmlBase::SkipWhiteSpace( const char* p, TiXmlEncoding encoding )
 	{
 		return 0;
 	}
-	if ( encoding == TIXML_ENCODING_UTF8 )
+	if ( TIXML_IS_UTF8( encoding ) )
 	{
 		while ( *p )
 		{
@@ -346,16 +615,16 @@ const char* TiXmlBase::SkipWhiteSpace( const char* p, TiXmlEncoding encoding )
 				continue;
 			}
 
-			if ( IsWhiteSpace( *p ) || *p == '\n' || *p =='\r' )		// Still using old rules for white space.
-				++p;
+			if ( IsWhiteSpace( *p ) )		// Still using old rules for white space.
+				p = TiXmlSkipSpace( p + 1 );
 			else
 				break;
 		}
 	}
 	else
 	{
-		while ( *p && (IsWhiteSpace( *p ) || *p == '\n' || *p =='\r') )
-			++p;
+		while ( IsWhiteSpace( *p ) )
+			p = TiXmlSkipSpace( p + 1 );
 	}
 
 	return p;
@@ -498,7 +767,7 @@ const char* TiXmlBase::GetEntity( const char* p, char* value, int* length, TiXml
 				--q;
 			}
 		}
-		if ( encoding == TIXML_ENCODING_UTF8 )
+		if ( TIXML_IS_UTF8( encoding ) )
 		{
 			// convert the UCS to UTF-8
 			ConvertUTF32ToUTF8( ucs, value, length );
@@ -535,6 +804,15 @@ bool TiXmlBase::StringEqual( const char* p,
 							 const char* tag,
 							 bool ignoreCase,
 							 TiXmlEncoding encoding )
+{
+	if ( TIXML_IS_UTF8( encoding ) )
+		return StringEqualAs< TIXML_ENCODING_UTF8 >( p, tag, ignoreCase );
+	else
+		return StringEqualAs< TIXML_ENCODING_LEGACY >( p, tag, ignoreCase );
+}
+
+template< TiXmlEncoding E >
+bool TiXmlBase::StringEqualAs( const char* p, const char* tag, bool ignoreCase )
 {
 	assert( p );
 	assert( tag );
@@ -548,7 +826,7 @@ bool TiXmlBase::StringEqual( const char* p,
 
 	if ( ignoreCase )
 	{
-		while ( *q && *tag && ToLower( *q, encoding ) == ToLower( *tag, encoding ) )
+		while ( *q && *tag && ToLower( *q, E ) == ToLower( *tag, E ) )
 		{
 			++q;
 			++tag;
@@ -577,19 +855,52 @@ const char* TiXmlBase::ReadText(	const char* p,
 									const char* endTag, 
 									bool caseInsensitive,
 									TiXmlEncoding encoding )
+{
+	if ( TIXML_IS_UTF8( encoding ) )
+		return ReadTextAs< TIXML_ENCODING_UTF8 >( p, text, trimWhiteSpace, endTag, caseInsensitive );
+	else
+		return ReadTextAs< TIXML_ENCODING_LEGACY >( p, text, trimWhiteSpace, endTag, caseInsensitive );
+}
+
+template< TiXmlEncoding E >
+const char* TiXmlBase::ReadTextAs(	const char* p, 
+									TIXML_STRING * text, 
+									bool trimWhiteSpace, 
+									const char* endTag, 
+									bool caseInsensitive )
 {
     *text = "";
+
+	// Runs of plain characters are found by TiXmlScanText and appended in
+	// one go. It stops at anything needing a closer look: a possible end tag,
+	// an entity, a multi-byte character and, when condensing, white space.
+	char stop = *endTag;
+	char stopAlt = stop;
+	if ( caseInsensitive )
+	{
+		stop = (char) tolower( (unsigned char) stop );
+		stopAlt = (char) toupper( (unsigned char) stop );
+	}
+
 	if (    !trimWhiteSpace			// certain tags always keep whitespace
 		 || !condenseWhiteSpace )	// if true, whitespace is always kept
 	{
 		// Keep all the white space.
 		while (	   p && *p
-				&& !StringEqual( p, endTag, caseInsensitive, encoding )
+				&& !StringEqualAs< E >( p, endTag, caseInsensitive )
 			  )
 		{
+			const char* run = TiXmlScanText( p, stop, stopAlt, false );
+			if ( run != p )
+			{
+				text->append( p, run - p );
+				p = run;
+				continue;
+			}
+
 			int len;
 			char cArr[4] = { 0, 0, 0, 0 };
-			p = GetChar( p, cArr, &len, encoding );
+			p = GetChar( p, cArr, &len, E );
 			text->append( cArr, len );
 		}
 	}
@@ -598,19 +909,14 @@ const char* TiXmlBase::ReadText(	const char* p,
 		bool whitespace = false;
 
 		// Remove leading white space:
-		p = SkipWhiteSpace( p, encoding );
+		p = SkipWhiteSpace( p, E );
 		while (	   p && *p
-				&& !StringEqual( p, endTag, caseInsensitive, encoding ) )
+				&& !StringEqualAs< E >( p, endTag, caseInsensitive ) )
 		{
-			if ( *p == '\r' || *p == '\n' )
+			if ( IsWhiteSpace( *p ) )
 			{
 				whitespace = true;
-				++p;
-			}
-			else if ( IsWhiteSpace( *p ) )
-			{
-				whitespace = true;
-				++p;
+				p = TiXmlSkipSpace( p + 1 );
 			}
 			else
 			{
@@ -621,9 +927,27 @@ const char* TiXmlBase::ReadText(	const char* p,
 					(*text) += ' ';
 					whitespace = false;
 				}
+
+				// A run already has its white space condensed, except
+				// for a single trailing ' ', which may yet be followed
+				// by more white space or the end tag.
+				const char* run = TiXmlScanText( p, stop, stopAlt, true );
+				if ( run != p )
+				{
+					if ( run[-1] == ' ' )
+					{
+						text->append( p, run - 1 - p );
+						whitespace = true;
+					}
+					else
+						text->append( p, run - p );
+					p = run;
+					continue;
+				}
+
 				int len;
 				char cArr[4] = { 0, 0, 0, 0 };
-				p = GetChar( p, cArr, &len, encoding );
+				p = GetChar( p, cArr, &len, E );
 				if ( len == 1 )
 					(*text) += cArr[0];	// more efficient
 				else
@@ -729,6 +1053,11 @@ const char* TiXmlDocument::Parse( const char* p, TiXmlParsingData* prevData, TiX
 		location.col = 0;
 	}
 	TiXmlParsingData data( p, TabSize(), location.row, location.col );
+	const TiXmlEncoding startEncoding = encoding;
+	data.interner = interner;
+	data.skipFilter = skipFilter;
+	data.rawText = rawText;
+	data.exactLocation = exactLocation;
 	location = data.Cursor();
 
 	if ( encoding == TIXML_ENCODING_UNKNOWN )
@@ -743,6 +1072,9 @@ const char* TiXmlDocument::Parse( const char* p, TiXmlParsingData* prevData, TiX
 			useMicrosoftBOM = true;
 		}
 	}
+#ifdef TIXML_UTF8_ONLY
+	encoding = TIXML_ENCODING_UTF8;
+#endif
 
     p = SkipWhiteSpace( p, encoding );
 	if ( !p )
@@ -751,6 +1083,22 @@ const char* TiXmlDocument::Parse( const char* p, TiXmlParsingData* prevData, TiX
 		return 0;
 	}
 
+	// Everything created from here on belongs to this document.
+	TiXmlArena::Scope scope( useArena ? &arena : 0 );
+
+	// With text decoded in parallel, first index the input to find the text
+	// worth handing to the workers. Nothing to hand over, no workers.
+	TiXmlTextIndex textIndex;
+	if ( parallelThreads > 0 )
+	{
+		TiXmlIndexText( data.base, parallelMinLength, &textIndex );
+		data.textIndex = &textIndex;
+		data.parallelMinLength = parallelMinLength;
+	}
+	TiXmlTextWorkers workers( textIndex.spans.empty() ? 0 : parallelThreads );
+	if ( !textIndex.spans.empty() )
+		data.workers = &workers;
+
 	while ( p && *p )
 	{
 		TiXmlNode* node = Identify( p, encoding );
@@ -784,6 +1132,23 @@ const char* TiXmlDocument::Parse( const char* p, TiXmlParsingData* prevData, TiX
 
 		p = SkipWhiteSpace( p, encoding );
 	}
+	if ( !workers.Finish() )
+	{
+		// Some text handed to the workers was malformed. Parse again on
+		// this thread alone, to stop exactly where, and how, that would.
+		// The first attempt's nodes are all gone, so is their storage.
+		Clear();
+		arena.Reset( keepArena );
+		int threads = parallelThreads;
+		parallelThreads = 0;
+		p = Parse( data.base, prevData, startEncoding );
+		parallelThreads = threads;
+		return p;
+	}
+	loadStats.arenaBytes = arena.BytesUsed();
+	loadStats.bytesSkipped = data.bytesSkipped;
+	loadStats.rawTextBytes = data.rawTextBytes + workers.RawTextBytes();
+	loadStats.parallelTextBytes = data.parallelTextBytes;
 
 	// Was this empty?
 	if ( !firstChild ) {
@@ -809,7 +1174,7 @@ void TiXmlDocument::SetError( int err, const char* pError, TiXmlParsingData* dat
 	errorLocation.Clear();
 	if ( pError && data )
 	{
-		data->Stamp( pError, encoding );
+		data->Locate( pError, encoding );
 		errorLocation = data->Cursor();
 	}
 }
@@ -1080,6 +1445,8 @@ const char* TiXmlElement::Parse( const char* p, TiXmlParsingData* data, TiXmlEnc
 		if ( document )	document->SetError( TIXML_ERROR_FAILED_TO_READ_ELEMENT_NAME, pErr, data, encoding );
 		return 0;
 	}
+	if ( data && data->interner )
+		nameId = data->interner( value.c_str(), value.length() );
 
     TIXML_STRING endTag ("</");
 	endTag += value;
@@ -1113,7 +1480,9 @@ const char* TiXmlElement::Parse( const char* p, TiXmlParsingData* data, TiXmlEnc
 			// Read the value -- which can include other
 			// elements -- read the end tag, and return.
 			++p;
+			if ( data ) ++data->depth;
 			p = ReadValue( p, data, encoding );		// Note this is an Element method, and will set the error if one happens.
+			if ( data ) --data->depth;
 			if ( !p || !*p ) {
 				// We were looking for the end tag, but found nothing.
 				// Fix for [ 1663758 ] Failure to report error on bad XML
@@ -1174,6 +1543,85 @@ const char* TiXmlElement::Parse( const char* p, TiXmlParsingData* data, TiXmlEnc
 }
 
 
+bool TiXmlElement::SkipElement( const char*& p, TiXmlParsingData* data )
+{
+	// Only elements are offered to the filter, not comments, declarations
+	// and the like.
+	const char* name = p + 1;
+	if ( !IsAlpha( (unsigned char) *name, TIXML_ENCODING_UNKNOWN ) && *name != '_' )
+		return false;
+
+	const char* nameEnd = name;
+	while ( *nameEnd && !IsWhiteSpace( *nameEnd ) && *nameEnd != '/' && *nameEnd != '>' )
+		++nameEnd;
+
+	if ( !data->skipFilter->Skip( name, nameEnd - name, data->depth ) )
+		return false;
+
+	// Scan for the end of the element, counting the elements opened and
+	// closed inside it. Nothing is checked beyond what it takes to find
+	// the tags.
+	const char* start = p;
+	int depth = 0;
+	while ( ( p = strchr( p, '<' ) ) != 0 )
+	{
+		if ( strncmp( p, "<!--", 4 ) == 0 )
+		{
+			p = strstr( p + 4, "-->" );
+			if ( p ) p += 3;
+		}
+		else if ( strncmp( p, "<![CDATA[", 9 ) == 0 )
+		{
+			p = strstr( p + 9, "]]>" );
+			if ( p ) p += 3;
+		}
+		else if ( p[1] == '?' )
+		{
+			p = strstr( p + 2, "?>" );
+			if ( p ) p += 2;
+		}
+		else if ( p[1] == '!' || p[1] == '/' )
+		{
+			bool endTag = p[1] == '/';
+			p = strchr( p + 2, '>' );
+			if ( p ) ++p;
+			if ( p && endTag && --depth == 0 )
+				break;
+		}
+		else
+		{
+			// A '>' inside a quoted attribute value doesn't end the tag.
+			char quote = 0;
+			for ( ++p; *p && ( quote || *p != '>' ); ++p )
+			{
+				if ( quote )
+				{
+					if ( *p == quote )
+						quote = 0;
+				}
+				else if ( *p == '"' || *p == '\'' )
+					quote = *p;
+			}
+			if ( !*p )
+				p = 0;
+			else if ( p[-1] != '/' )
+				++depth;
+			else if ( depth == 0 )
+			{
+				++p;
+				break;
+			}
+		}
+		if ( !p )
+			break;
+	}
+
+	if ( p )
+		data->bytesSkipped += p - start;
+	return true;
+}
+
+
 const char* TiXmlElement::ReadValue( const char* p, TiXmlParsingData* data, TiXmlEncoding encoding )
 {
 	TiXmlDocument* document = GetDocument();
@@ -1206,7 +1654,8 @@ const char* TiXmlElement::ReadValue( const char* p, TiXmlParsingData* data, TiXm
 				p = textNode->Parse( pWithWhiteSpace, data, encoding );
 			}
 
-			if ( !textNode->Blank() )
+			// Text left to a worker is known not to be blank.
+			if ( ( data && data->textDeferred ) || !textNode->Blank() )
 				LinkEndChild( textNode );
 			else
 				delete textNode;
@@ -1220,6 +1669,15 @@ const char* TiXmlElement::ReadValue( const char* p, TiXmlParsingData* data, TiXm
 			{
 				return p;
 			}
+			else if ( data && data->skipFilter && SkipElement( p, data ) )
+			{
+				// Passed over; p now follows its end tag.
+				if ( !p )
+				{
+					if ( document ) document->SetError( TIXML_ERROR_READING_END_TAG, 0, 0, encoding );
+					return 0;
+				}
+			}
 			else
 			{
 				TiXmlNode* node = Identify( p, encoding );
@@ -1495,6 +1953,31 @@ void TiXmlText::StreamIn( std::istream * in, TIXML_STRING * tag )
 }
 #endif
 
+// Whether the text from 'p' to 'end' can go to a worker: it has to be long
+// enough, not blank, and end where Parse() would end it.
+static bool DeferText( const char* p, const char* end, const TiXmlParsingData* data, TiXmlEncoding encoding )
+{
+	if ( (size_t) ( end - p ) < data->parallelMinLength )
+		return false;
+
+	// The first character that isn't white space makes the text not blank,
+	// unless it is an entity that turns out to be.
+	const char* q = TiXmlSkipSpace( p );
+	if ( q == end || *q == '&' )
+		return false;
+
+	// A multi-byte character cut off by the '<' would be read through it.
+	if ( TIXML_IS_UTF8( encoding ) )
+	{
+		for ( int i = 1; i <= 3 && end - i >= p; ++i )
+		{
+			if ( TiXmlBase::utf8ByteTable[ (unsigned char) end[ -i ] ] > i )
+				return false;
+		}
+	}
+	return true;
+}
+
 const char* TiXmlText::Parse( const char* p, TiXmlParsingData* data, TiXmlEncoding encoding )
 {
 	value = "";
@@ -1504,6 +1987,10 @@ const char* TiXmlText::Parse( const char* p, TiXmlParsingData* data, TiXmlEncodi
 	{
 		data->Stamp( p, encoding );
 		location = data->Cursor();
+
+		// Whatever the text before was, this one is parsed here unless
+		// it is handed to a worker below.
+		data->textDeferred = false;
 	}
 
 	const char* const startTag = "<![CDATA[";
@@ -1521,13 +2008,11 @@ const char* TiXmlText::Parse( const char* p, TiXmlParsingData* data, TiXmlEncodi
 		p += strlen( startTag );
 
 		// Keep all the white space, ignore the encoding, etc.
-		while (	   p && *p
-				&& !StringEqual( p, endTag, false, encoding )
-			  )
-		{
-			value += *p;
-			++p;
-		}
+		const char* end = strstr( p, endTag );
+		if ( !end )
+			end = p + strlen( p );
+		value.assign( p, end - p );
+		p = end;
 
 		TIXML_STRING dummy; 
 		p = ReadText( p, &dummy, false, endTag, false, encoding );
@@ -1535,6 +2020,35 @@ const char* TiXmlText::Parse( const char* p, TiXmlParsingData* data, TiXmlEncodi
 	}
 	else
 	{
+		if ( data && data->workers )
+		{
+			const TiXmlTextSpan* span = data->FindSpan( p );
+			const char* textEnd = span ? data->base + span->end : 0;
+			if ( textEnd && DeferText( p, textEnd, data, encoding ) )
+			{
+				data->workers->Add( this, p, textEnd, data->rawText, encoding );
+				data->parallelTextBytes += textEnd - p;
+				data->textDeferred = true;
+				data->StampSpan( textEnd, *span, encoding );
+				return textEnd;
+			}
+		}
+
+		if ( data && data->rawText )
+		{
+			// Text runs to the next markup. Without entities there is
+			// nothing to decode, so take it as it stands.
+			const char* textEnd = strchr( p, '<' );
+			if ( !textEnd )
+				textEnd = p + strlen( p );
+			if ( !memchr( p, '&', textEnd - p ) )
+			{
+				value.assign( p, textEnd - p );
+				data->rawTextBytes += textEnd - p;
+				return textEnd;
+			}
+		}
+
 		bool ignoreWhite = true;
 
 		const char* end = "<";
@@ -1545,6 +2059,21 @@ const char* TiXmlText::Parse( const char* p, TiXmlParsingData* data, TiXmlEncodi
 	}
 }
 
+bool TiXmlText::DecodeText( const char* p, const char* end, bool raw, TiXmlEncoding encoding,
+							TIXML_STRING* text, size_t* rawTextBytes )
+{
+	// The same as Parse(), given where the text ends.
+	if ( raw && !memchr( p, '&', end - p ) )
+	{
+		text->assign( p, end - p );
+		*rawTextBytes = end - p;
+		return true;
+	}
+
+	p = ReadText( p, text, true, "<", false, encoding );
+	return p && p - 1 == end;
+}
+
 #ifdef TIXML_USE_STL
 void TiXmlDeclaration::StreamIn( std::istream * in, TIXML_STRING * tag )
 {
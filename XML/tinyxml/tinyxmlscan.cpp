@@ -0,0 +1,462 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+#include <stdint.h>
+
+#include "tinyxmlscan.h"
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#	define TIXML_SCAN_X86
+#	include <immintrin.h>
+#	define TIXML_SCAN_KERNEL( isa ) __attribute__(( target( isa ), no_sanitize_address, no_sanitize_thread ))
+#endif
+
+namespace {
+
+inline bool IsSpaceByte( unsigned char c )
+{
+	return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
+
+/*	Bit i of each mask describes byte i of a 64 byte block.
+*/
+struct IndexMasks
+{
+	uint64_t lt;
+	uint64_t newline;
+	uint64_t special;	// '\t' or 0x80 and up
+	uint64_t cr;
+	uint64_t nul;
+};
+
+/*------------------------------- Scalar -----------------------------------*/
+
+const char* SkipSpaceScalar( const char* p )
+{
+	while ( IsSpaceByte( *p ) )
+		++p;
+	return p;
+}
+
+const char* ScanTextScalar( const char* p, char stop, char stopAlt, bool condense )
+{
+	for ( const char* start = p; ; ++p )
+	{
+		unsigned char c = *p;
+		if ( !c || c == '&' || *p == stop || *p == stopAlt || c >= 0x80 )
+			return p;
+		if (    condense
+			 && ( ( c >= '\t' && c <= '\r' ) || ( c == ' ' && p > start && p[-1] == ' ' ) ) )
+			return p;
+	}
+}
+
+const char* ScanColumnsScalar( const char* p, const char* end )
+{
+	for ( ; p < end; ++p )
+	{
+		unsigned char c = *p;
+		if ( !c || c == '\t' || c == '\n' || c == '\r' || c >= 0x80 )
+			return p;
+	}
+	return end;
+}
+
+void IndexTextScalar( const char* p, size_t minLength, TiXmlTextIndex* index )
+{
+	TiXmlTextSpan span = { 0, 0, 0, 0, false };
+	for ( const char* q = p; ; ++q )
+	{
+		unsigned char c = *q;
+		if ( c == '<' || !c )
+		{
+			span.end = q - p;
+			if ( span.end - span.start >= minLength )
+				index->spans.push_back( span );
+			if ( !c )
+				return;
+			TiXmlTextSpan next = { span.end + 1, 0, 0, 0, false };
+			span = next;
+		}
+		else if ( c == '\n' )
+		{
+			++span.newlines;
+			span.lastNewline = q - p;
+		}
+		else if ( c == '\r' )
+			index->carriageReturn = true;
+		else if ( c == '\t' || c >= 0x80 )
+			span.special = true;
+	}
+}
+
+/*	The vector versions share this loop; only building the masks of a block
+	differs.
+*/
+void IndexText( const char* p, size_t minLength, TiXmlTextIndex* index,
+				void (*buildMasks)( const char*, IndexMasks* ) )
+{
+	unsigned offset = (uintptr_t) p & 63;
+	const char* block = p - offset;
+	uint64_t valid = ~(uint64_t) 0 << offset;
+	TiXmlTextSpan span = { 0, 0, 0, 0, false };
+	for ( ;; block += 64, valid = ~(uint64_t) 0 )
+	{
+		IndexMasks masks;
+		buildMasks( block, &masks );
+
+		// Nothing after the null counts.
+		uint64_t nul = masks.nul & valid;
+		uint64_t live = nul ? valid & ( ( nul & ( 0 - nul ) ) - 1 ) : valid;
+		if ( masks.cr & live )
+			index->carriageReturn = true;
+
+		// Walk the '<' of the block, closing a span at each.
+		size_t blockStart = block - p;		// wraps for the first block, but only bits at or after p are used
+		uint64_t rest = live;
+		uint64_t lt = masks.lt & live;
+		for ( ;; )
+		{
+			uint64_t upTo = lt ? ( lt & ( 0 - lt ) ) - 1 : ~(uint64_t) 0;
+			uint64_t bits = rest & upTo;
+			uint64_t newlines = masks.newline & bits;
+			if ( newlines )
+			{
+				span.newlines += __builtin_popcountll( newlines );
+				span.lastNewline = blockStart + 63 - __builtin_clzll( newlines );
+			}
+			if ( masks.special & bits )
+				span.special = true;
+
+			if ( !lt )
+				break;
+			span.end = blockStart + __builtin_ctzll( lt );
+			if ( span.end - span.start >= minLength )
+				index->spans.push_back( span );
+			TiXmlTextSpan next = { span.end + 1, 0, 0, 0, false };
+			span = next;
+
+			rest &= ~( upTo | ( lt & ( 0 - lt ) ) );
+			lt &= lt - 1;
+		}
+
+		if ( nul )
+		{
+			span.end = blockStart + __builtin_ctzll( nul );
+			if ( span.end - span.start >= minLength )
+				index->spans.push_back( span );
+			return;
+		}
+	}
+}
+
+#ifdef TIXML_SCAN_X86
+
+/*-------------------------------- SSE2 ------------------------------------*/
+
+/*	Bit i of the masks below describes byte i of a block. Control white
+	space, '\t' to '\r', is found by moving that range to the bottom of the
+	signed byte range so one compare suffices.
+*/
+TIXML_SCAN_KERNEL( "sse2" )
+unsigned ControlSpaceBits16( __m128i v )
+{
+	__m128i shifted = _mm_add_epi8( v, _mm_set1_epi8( 0x80 - '\t' ) );
+	return _mm_movemask_epi8( _mm_cmplt_epi8( shifted, _mm_set1_epi8( -128 + ( '\r' - '\t' ) + 1 ) ) );
+}
+
+TIXML_SCAN_KERNEL( "sse2" )
+const char* SkipSpaceSSE2( const char* p )
+{
+	unsigned offset = (uintptr_t) p & 15;
+	const char* block = p - offset;
+	unsigned valid = ( 0xffffu << offset ) & 0xffffu;	// 16 bits, like the masks
+	for ( ;; )
+	{
+		__m128i v = _mm_load_si128( (const __m128i*) block );
+		unsigned space = ControlSpaceBits16( v )
+					   | _mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_set1_epi8( ' ' ) ) );
+		unsigned mask = ~space & valid;
+		if ( mask )
+			return block + __builtin_ctz( mask );
+		block += 16;
+		valid = 0xffffu;
+	}
+}
+
+TIXML_SCAN_KERNEL( "sse2" )
+const char* ScanTextSSE2( const char* p, char stop, char stopAlt, bool condense )
+{
+	const __m128i vStop = _mm_set1_epi8( stop );
+	const __m128i vStopAlt = _mm_set1_epi8( stopAlt );
+	const __m128i vAmp = _mm_set1_epi8( '&' );
+	const __m128i vBlank = _mm_set1_epi8( ' ' );
+	const __m128i vZero = _mm_setzero_si128();
+
+	unsigned offset = (uintptr_t) p & 15;
+	const char* block = p - offset;
+	unsigned valid = ( 0xffffu << offset ) & 0xffffu;	// 16 bits, like the masks
+	unsigned carry = 0;		// last byte of the previous block was a ' '
+	for ( ;; )
+	{
+		__m128i v = _mm_load_si128( (const __m128i*) block );
+		__m128i hit = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, vZero ), _mm_cmpeq_epi8( v, vAmp ) ),
+									_mm_or_si128( _mm_cmpeq_epi8( v, vStop ), _mm_cmpeq_epi8( v, vStopAlt ) ) );
+		// The sign bits of 'v' itself flag the non-ASCII bytes.
+		unsigned mask = _mm_movemask_epi8( _mm_or_si128( hit, v ) );
+		if ( condense )
+		{
+			unsigned blank = _mm_movemask_epi8( _mm_cmpeq_epi8( v, vBlank ) ) & valid;
+			mask |= ControlSpaceBits16( v ) | ( blank & ( ( blank << 1 ) | carry ) );
+			carry = blank >> 15;
+		}
+		mask &= valid;
+		if ( mask )
+			return block + __builtin_ctz( mask );
+		block += 16;
+		valid = 0xffffu;
+	}
+}
+
+/*	Bounded by 'end' rather than the null, so these use unaligned loads and
+	leave the tail to the scalar version.
+*/
+TIXML_SCAN_KERNEL( "sse2" )
+const char* ScanColumnsSSE2( const char* p, const char* end )
+{
+	for ( ; end - p >= 16; p += 16 )
+	{
+		__m128i v = _mm_loadu_si128( (const __m128i*) p );
+		__m128i hit = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, _mm_setzero_si128() ), _mm_cmpeq_epi8( v, _mm_set1_epi8( '\t' ) ) ),
+									_mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( '\n' ) ), _mm_cmpeq_epi8( v, _mm_set1_epi8( '\r' ) ) ) );
+		unsigned mask = _mm_movemask_epi8( _mm_or_si128( hit, v ) );
+		if ( mask )
+			return p + __builtin_ctz( mask );
+	}
+	return ScanColumnsScalar( p, end );
+}
+
+TIXML_SCAN_KERNEL( "sse2" )
+void IndexMasksSSE2( const char* block, IndexMasks* masks )
+{
+	IndexMasks m = { 0, 0, 0, 0, 0 };
+	for ( int i = 0; i < 64; i += 16 )
+	{
+		__m128i v = _mm_load_si128( (const __m128i*) ( block + i ) );
+		m.lt |= (uint64_t)(unsigned) _mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_set1_epi8( '<' ) ) ) << i;
+		m.newline |= (uint64_t)(unsigned) _mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_set1_epi8( '\n' ) ) ) << i;
+		m.special |= (uint64_t)(unsigned) _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, _mm_set1_epi8( '\t' ) ), v ) ) << i;
+		m.cr |= (uint64_t)(unsigned) _mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_set1_epi8( '\r' ) ) ) << i;
+		m.nul |= (uint64_t)(unsigned) _mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_setzero_si128() ) ) << i;
+	}
+	*masks = m;
+}
+
+/*-------------------------------- AVX2 ------------------------------------*/
+
+TIXML_SCAN_KERNEL( "avx2" )
+unsigned ControlSpaceBits32( __m256i v )
+{
+	__m256i shifted = _mm256_add_epi8( v, _mm256_set1_epi8( 0x80 - '\t' ) );
+	return _mm256_movemask_epi8( _mm256_cmpgt_epi8( _mm256_set1_epi8( -128 + ( '\r' - '\t' ) + 1 ), shifted ) );
+}
+
+TIXML_SCAN_KERNEL( "avx2" )
+const char* SkipSpaceAVX2( const char* p )
+{
+	unsigned offset = (uintptr_t) p & 31;
+	const char* block = p - offset;
+	unsigned valid = 0xffffffffu << offset;
+	for ( ;; )
+	{
+		__m256i v = _mm256_load_si256( (const __m256i*) block );
+		unsigned space = ControlSpaceBits32( v )
+					   | _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( ' ' ) ) );
+		unsigned mask = ~space & valid;
+		if ( mask )
+			return block + __builtin_ctz( mask );
+		block += 32;
+		valid = 0xffffffffu;
+	}
+}
+
+TIXML_SCAN_KERNEL( "avx2" )
+const char* ScanTextAVX2( const char* p, char stop, char stopAlt, bool condense )
+{
+	const __m256i vStop = _mm256_set1_epi8( stop );
+	const __m256i vStopAlt = _mm256_set1_epi8( stopAlt );
+	const __m256i vAmp = _mm256_set1_epi8( '&' );
+	const __m256i vBlank = _mm256_set1_epi8( ' ' );
+	const __m256i vZero = _mm256_setzero_si256();
+
+	unsigned offset = (uintptr_t) p & 31;
+	const char* block = p - offset;
+	unsigned valid = 0xffffffffu << offset;
+	unsigned carry = 0;
+	for ( ;; )
+	{
+		__m256i v = _mm256_load_si256( (const __m256i*) block );
+		__m256i hit = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8( v, vZero ), _mm256_cmpeq_epi8( v, vAmp ) ),
+									   _mm256_or_si256( _mm256_cmpeq_epi8( v, vStop ), _mm256_cmpeq_epi8( v, vStopAlt ) ) );
+		unsigned mask = _mm256_movemask_epi8( _mm256_or_si256( hit, v ) );
+		if ( condense )
+		{
+			unsigned blank = _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, vBlank ) ) & valid;
+			mask |= ControlSpaceBits32( v ) | ( blank & ( ( blank << 1 ) | carry ) );
+			carry = blank >> 31;
+		}
+		mask &= valid;
+		if ( mask )
+			return block + __builtin_ctz( mask );
+		block += 32;
+		valid = 0xffffffffu;
+	}
+}
+
+TIXML_SCAN_KERNEL( "avx2" )
+const char* ScanColumnsAVX2( const char* p, const char* end )
+{
+	for ( ; end - p >= 32; p += 32 )
+	{
+		__m256i v = _mm256_loadu_si256( (const __m256i*) p );
+		__m256i hit = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_setzero_si256() ), _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\t' ) ) ),
+									   _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\n' ) ), _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\r' ) ) ) );
+		unsigned mask = _mm256_movemask_epi8( _mm256_or_si256( hit, v ) );
+		if ( mask )
+			return p + __builtin_ctz( mask );
+	}
+	return ScanColumnsSSE2( p, end );
+}
+
+TIXML_SCAN_KERNEL( "avx2" )
+void IndexMasksAVX2( const char* block, IndexMasks* masks )
+{
+	IndexMasks m = { 0, 0, 0, 0, 0 };
+	for ( int i = 0; i < 64; i += 32 )
+	{
+		__m256i v = _mm256_load_si256( (const __m256i*) ( block + i ) );
+		m.lt |= (uint64_t)(unsigned) _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '<' ) ) ) << i;
+		m.newline |= (uint64_t)(unsigned) _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\n' ) ) ) << i;
+		m.special |= (uint64_t)(unsigned) _mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\t' ) ), v ) ) << i;
+		m.cr |= (uint64_t)(unsigned) _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_set1_epi8( '\r' ) ) ) << i;
+		m.nul |= (uint64_t)(unsigned) _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, _mm256_setzero_si256() ) ) << i;
+	}
+	*masks = m;
+}
+
+#endif
+
+/*------------------------------- Dispatch ---------------------------------*/
+
+struct Kernels
+{
+	TiXmlScanLevel level;
+	const char* (*skipSpace)( const char* );
+	const char* (*scanText)( const char*, char, char, bool );
+	const char* (*scanColumns)( const char*, const char* );
+	void (*indexMasks)( const char*, IndexMasks* );		// null for scalar
+};
+
+TiXmlScanLevel SupportedLevel()
+{
+	#ifdef TIXML_SCAN_X86
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports( "avx2" ) )
+		return TIXML_SCAN_AVX2;
+	if ( __builtin_cpu_supports( "sse2" ) )
+		return TIXML_SCAN_SSE2;
+	#endif
+	return TIXML_SCAN_SCALAR;
+}
+
+Kernels SelectKernels( TiXmlScanLevel level )
+{
+	TiXmlScanLevel supported = SupportedLevel();
+	if ( level > supported )
+		level = supported;
+
+	Kernels kernels = { TIXML_SCAN_SCALAR, SkipSpaceScalar, ScanTextScalar, ScanColumnsScalar, 0 };
+	#ifdef TIXML_SCAN_X86
+	if ( level == TIXML_SCAN_AVX2 )
+	{
+		Kernels avx2 = { level, SkipSpaceAVX2, ScanTextAVX2, ScanColumnsAVX2, IndexMasksAVX2 };
+		kernels = avx2;
+	}
+	else if ( level == TIXML_SCAN_SSE2 )
+	{
+		Kernels sse2 = { level, SkipSpaceSSE2, ScanTextSSE2, ScanColumnsSSE2, IndexMasksSSE2 };
+		kernels = sse2;
+	}
+	#endif
+	return kernels;
+}
+
+Kernels& ActiveKernels()
+{
+	static Kernels kernels = SelectKernels( TIXML_SCAN_AVX2 );
+	return kernels;
+}
+
+}
+
+TiXmlScanLevel TiXmlGetScanLevel()
+{
+	return ActiveKernels().level;
+}
+
+void TiXmlSetScanLevel( TiXmlScanLevel level )
+{
+	ActiveKernels() = SelectKernels( level );
+}
+
+const char* TiXmlSkipSpace( const char* p )
+{
+	// Most runs are empty or a single separator; don't pay for a call.
+	if ( !IsSpaceByte( *p ) )
+		return p;
+	if ( !IsSpaceByte( p[1] ) )
+		return p + 1;
+	return ActiveKernels().skipSpace( p + 2 );
+}
+
+const char* TiXmlScanText( const char* p, char stop, char stopAlt, bool condense )
+{
+	return ActiveKernels().scanText( p, stop, stopAlt, condense );
+}
+
+const char* TiXmlScanColumns( const char* p, const char* end )
+{
+	return ActiveKernels().scanColumns( p, end );
+}
+
+void TiXmlIndexText( const char* p, size_t minLength, TiXmlTextIndex* index )
+{
+	index->spans.clear();
+	index->carriageReturn = false;
+
+	const Kernels& kernels = ActiveKernels();
+	if ( kernels.indexMasks )
+		IndexText( p, minLength, index, kernels.indexMasks );
+	else
+		IndexTextScalar( p, minLength, index );
+}
@@ -0,0 +1,105 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+#ifndef TIXML_SCAN_INCLUDED
+#define TIXML_SCAN_INCLUDED
+
+#include <stddef.h>
+#include <vector>
+
+/*	Byte scanning kernels used by the parser to move over white space and
+	character data many bytes at a time. Each kernel has a scalar version and,
+	on x86, SSE2 and AVX2 versions; the best one the CPU supports is picked the
+	first time a kernel is used. All kernels stop at the terminating null.
+
+	The vector versions only ever load whole aligned blocks, so they never
+	touch a page the null isn't on. They may read past the null within its
+	block, which is why they are hidden from the address and thread sanitizers.
+
+	White space here is ' ', '\t', '\n', '\v', '\f' and '\r': what
+	TiXmlBase::IsWhiteSpace accepts in the "C" locale.
+*/
+
+enum TiXmlScanLevel
+{
+	TIXML_SCAN_SCALAR,
+	TIXML_SCAN_SSE2,
+	TIXML_SCAN_AVX2
+};
+
+/*	The kernels in use. Starts at the best level the CPU supports.
+*/
+TiXmlScanLevel TiXmlGetScanLevel();
+
+/*	Use the kernels of 'level', or of the best level below it the CPU supports.
+	Meant for testing and benchmarking the fallbacks; not thread safe.
+*/
+void TiXmlSetScanLevel( TiXmlScanLevel level );
+
+/*	Return the first byte at or after 'p' that is not white space.
+*/
+const char* TiXmlSkipSpace( const char* p );
+
+/*	Return the first byte at or after 'p' that character data can't be copied
+	through unchanged: the null, '&', 'stop', 'stopAlt' or a byte of 0x80 and
+	up. With 'condense' set, also stop at white space other than a single ' ',
+	ie. at any of '\t' to '\r' and at a ' ' that follows another ' ' at or
+	after 'p'.
+*/
+const char* TiXmlScanText( const char* p, char stop, char stopAlt, bool condense );
+
+/*	Return the first byte in [p, end) that isn't one column wide on its own:
+	the null, '\t', '\n', '\r' or a byte of 0x80 and up. Return 'end' if
+	there is none. Reads nothing at or after 'end'.
+*/
+const char* TiXmlScanColumns( const char* p, const char* end );
+
+/*	A run of input between two consecutive '<', as found by TiXmlIndexText.
+	Offsets count from the start of the indexed text.
+*/
+struct TiXmlTextSpan
+{
+	size_t start;		// Just past the '<' before the span, 0 for the first span.
+	size_t end;			// The '<', or the null, ending the span.
+	size_t newlines;	// Number of '\n' in the span.
+	size_t lastNewline;	// Offset of the last of them, if any.
+	bool special;		// The span holds a tab or a byte of 0x80 and up.
+};
+
+/*	The structural index of a document: its long spans, in order.
+*/
+struct TiXmlTextIndex
+{
+	std::vector< TiXmlTextSpan > spans;
+	bool carriageReturn;	// The text holds a '\r' somewhere.
+};
+
+/*	Index the text starting at 'p', up to its terminating null, recording every
+	span at least 'minLength' bytes long. This is the first stage of parsing
+	with text decoded in parallel: with the index the parser can step over
+	long text without reading it, and knows where it ends to hand it to a
+	worker. Looks at 64 bytes per step.
+*/
+void TiXmlIndexText( const char* p, size_t minLength, TiXmlTextIndex* index );
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef _TEST_UTIL_H_
+#define _TEST_UTIL_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <ColladaLoader.h>
+
+// the tests are small programs that print what doesn't hold and exit
+// with the number of failures
+
+static int testFailures = 0;
+
+#define CHECK(_condition) \
+  checkThat((_condition), #_condition, __FILE__, __LINE__)
+
+inline bool
+checkThat(bool _condition, const char* _text, const char* _file, int _line){
+
+  if(!_condition){
+
+    printf("%s:%d: failed: %s\n", _file, _line, _text);
+    testFailures++;
+
+  }
+
+  return _condition;
+
+}
+
+inline int
+testResult(const char* _name){
+
+  printf("%s: %s\n", _name, testFailures ? "FAILED" : "ok");
+
+  return testFailures;
+
+}
+
+// the fixtures, relative to tests/, where make check runs them
+inline string
+testData(const string& _name){
+
+  return "data/" + _name;
+
+}
+
+// a file of this process's own under /tmp, for tests that need input
+// the fixtures don't have
+inline string
+writeTemporary(const string& _name, const string& _text){
+
+  string filename = "/tmp/colladaloader_" + to_string(getpid()) + "_" + _name;
+
+  FILE* file = fopen(filename.c_str(), "wb");
+  fwrite(_text.data(), 1, _text.size(), file);
+  fclose(file);
+
+  return filename;
+
+}
+
+inline string
+readFile(const string& _filename){
+
+  string text;
+
+  FILE* file = fopen(_filename.c_str(), "rb");
+
+  if(!file)
+    return text;
+
+  char buffer[4096];
+  size_t length;
+
+  while((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    text.append(buffer, length);
+
+  fclose(file);
+
+  return text;
+
+}
+
+// FNV-1a over the bytes of a scene's output, so whole loads can be
+// compared with each other and with a known value
+class SceneHash {
+
+  public:
+
+    uint64_t value = 1469598103934665603ull;
+
+    void
+    add(const void* _data, size_t _length){
+
+      const unsigned char* bytes = (const unsigned char*)_data;
+
+      for(size_t i = 0; i < _length; i++){
+
+        value ^= bytes[i];
+        value *= 1099511628211ull;
+
+      }
+
+    }
+
+    // the vertices of every polylist, corner by corner, whichever
+    // layout the load was asked for
+    void
+    addGeometries(const ColladaLoader::Scene& _scene){
+
+      for(auto& geometry : _scene.geometries()){
+
+        for(auto& polylist : geometry.polylistCollection){
+
+          size_t corners = polylist.indices.empty() ?
+              polylist.vertexCollection.size() + polylist.vertexArrays.positions.size() :
+              polylist.indices.size();
+
+          for(size_t c = 0; c < corners; c++){
+
+            size_t v = polylist.indices.empty() ? c : polylist.indices[c];
+
+            if(polylist.vertexArrays.positions.empty()){
+
+              addVertex(polylist.vertexCollection[v].position,
+                        polylist.vertexCollection[v].normal,
+                        polylist.vertexCollection[v].texture);
+
+            } else{
+
+              addVertex(polylist.vertexArrays.positions[v],
+                        polylist.vertexArrays.normals[v],
+                        polylist.vertexArrays.textures[v]);
+
+            }
+
+          }
+
+        }
+
+      }
+
+    }
+
+    void
+    addMaterials(const ColladaLoader::Scene& _scene){
+
+      for(auto& material : _scene.materials()){
+
+        add(&material.emission, sizeof(glm::vec4));
+        add(&material.ambient, sizeof(glm::vec4));
+        add(&material.diffuse, sizeof(glm::vec4));
+        add(&material.specular, sizeof(glm::vec4));
+        add(&material.reflective, sizeof(glm::vec4));
+        add(&material.transparent, sizeof(glm::vec4));
+        add(&material.shininess, sizeof(float));
+        add(&material.refractionIndex, sizeof(float));
+        add(&material.reflectivity, sizeof(float));
+        add(&material.transparency, sizeof(float));
+
+      }
+
+    }
+
+  private:
+
+    void
+    addVertex(const glm::vec3& _position, const glm::vec3& _normal,
+              const glm::vec2& _texture){
+
+      add(&_position, sizeof(glm::vec3));
+      add(&_normal, sizeof(glm::vec3));
+      add(&_texture, sizeof(glm::vec2));
+
+    }
+
+};
+
+inline uint64_t
+hashGeometries(const ColladaLoader::Scene& _scene){
+
+  SceneHash hash;
+  hash.addGeometries(_scene);
+
+  return hash.value;
+
+}
+
+inline uint64_t
+hashScene(const ColladaLoader::Scene& _scene){
+
+  SceneHash hash;
+  hash.addGeometries(_scene);
+  hash.addMaterials(_scene);
+
+  return hash.value;
+
+}
+
+#endif
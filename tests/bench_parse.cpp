@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <tinyxml/tinyxml.h>
+
+using namespace std;
+
+// the cost per byte of building a tinyxml tree from a file held in
+// memory, for each encoding the parser is specialized on. run as
+//   make bench FILE=big.dae
+// the best of seven runs is reported. rebuild XML/ with
+// -DTIXML_UTF8_ONLY to time the parser compiled for UTF-8 alone.
+//   make bench-baseline FILE=big.dae
+// builds XML/ as it was before the encoding specialization and times
+// it with this same program, which is why only tinyxml is used here
+
+namespace {
+
+  string
+  readFile(const string& _filename){
+
+    string text;
+
+    FILE* file = fopen(_filename.c_str(), "rb");
+
+    if(!file)
+      return text;
+
+    char buffer[1 << 16];
+
+    for(size_t read; (read = fread(buffer, 1, sizeof(buffer), file)) > 0;)
+      text.append(buffer, read);
+
+    fclose(file);
+
+    return text;
+
+  }
+
+}
+
+int
+main(int _argc, char** _argv){
+
+  string filename = _argc > 1 ? _argv[1] : "data/mesh.dae";
+  string text = readFile(filename);
+
+  if(text.empty()){
+
+    printf("can't read %s\n", filename.c_str());
+    return 1;
+
+  }
+
+  const char* names[] = {"unknown", "utf8", "legacy"};
+  TiXmlEncoding encodings[] = {TIXML_ENCODING_UNKNOWN, TIXML_ENCODING_UTF8,
+                               TIXML_ENCODING_LEGACY};
+
+  printf("%s, %zu bytes\n", filename.c_str(), text.size());
+
+  for(int e = 0; e < 3; e++){
+
+    double best = 0;
+
+    for(int run = 0; run < 7; run++){
+
+      TiXmlDocument doc;
+
+      auto start = chrono::steady_clock::now();
+      doc.Parse(text.c_str(), 0, encodings[e]);
+      double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+      if(doc.Error()){
+
+        printf("%s: %s\n", names[e], doc.ErrorDesc());
+        return 1;
+
+      }
+
+      if(run == 0 || seconds < best)
+        best = seconds;
+
+    }
+
+    printf("%-8s %.2f ns/byte\n", names[e], best * 1e9 / text.size());
+
+  }
+
+  return 0;
+
+}
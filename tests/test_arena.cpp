@@ -0,0 +1,87 @@
+#include <TestUtil.h>
+
+// a tree built in the document's arena must be the same tree as one
+// built on the heap, and must mix with nodes added after the parse
+
+namespace {
+
+  const uint64_t meshSceneHash = 0x1f9b5111e812a3f5ull;
+
+  string
+  print(const TiXmlNode& _node){
+
+    TiXmlPrinter printer;
+    _node.Accept(&printer);
+
+    return printer.Str();
+
+  }
+
+}
+
+int
+main(){
+
+  string text = readFile(testData("mesh.dae"));
+
+  TiXmlDocument heap;
+  heap.Parse(text.c_str());
+
+  CHECK(!heap.Error());
+  CHECK(heap.LoadStats().arenaBytes == 0);
+
+  TiXmlDocument arena;
+  arena.SetUseArena(true);
+  arena.Parse(text.c_str());
+
+  CHECK(!arena.Error());
+  CHECK(arena.LoadStats().arenaBytes > 0);
+  CHECK(print(arena) == print(heap));
+
+  // nodes added, copied and removed after the parse come from the
+  // heap, next to those in the arena
+  TiXmlElement* root = arena.RootElement();
+
+  root->InsertEndChild(TiXmlElement("added"));
+  root->LinkEndChild(new TiXmlText("linked"));
+  root->RemoveChild(root->FirstChildElement("asset"));
+
+  TiXmlDocument copy(arena);
+  CHECK(print(copy) == print(arena));
+
+  heap.RootElement()->InsertEndChild(TiXmlElement("added"));
+  heap.RootElement()->LinkEndChild(new TiXmlText("linked"));
+  heap.RootElement()->RemoveChild(heap.RootElement()->FirstChildElement("asset"));
+
+  CHECK(print(arena) == print(heap));
+
+  // loading again starts the arena over, whether or not it keeps its
+  // blocks for the new tree
+  size_t arenaBytes = arena.LoadStats().arenaBytes;
+
+  for(bool keepArena : {false, true}){
+
+    arena.SetKeepArena(keepArena);
+
+    CHECK(arena.LoadFile(testData("mesh.dae")));
+    CHECK(arena.LoadStats().arenaBytes == arenaBytes);
+
+  }
+
+  CHECK(heap.LoadFile(testData("mesh.dae")));
+  CHECK(print(arena) == print(heap));
+
+  // and the loader reads the same scene either way
+  for(bool useArena : {false, true}){
+
+    ColladaLoader loader;
+    ColladaLoader::LoadOptions options;
+    options.xml.arena = useArena;
+
+    CHECK(hashScene(loader.parseCollada(testData("mesh.dae"), "COLLADA", options)) == meshSceneHash);
+
+  }
+
+  return testResult("test_arena");
+
+}
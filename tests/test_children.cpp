@@ -0,0 +1,153 @@
+#include <TestUtil.h>
+
+#include <iostream>
+#include <sstream>
+
+// XMLNode iterates the child elements of a node by following the
+// sibling links: comments are passed over, anything else that isn't an
+// element is an error, and warnAll still knows what was read
+
+namespace {
+
+  string
+  names(XMLNode& _node){
+
+    string list;
+
+    for(auto& child : _node)
+      list += child.name() + " ";
+
+    return list;
+
+  }
+
+  // what warnAll reports, which goes to cerr
+  string
+  warnings(XMLNode& _root, bool& _threw){
+
+    ostringstream captured;
+    streambuf* saved = cerr.rdbuf(captured.rdbuf());
+
+    _threw = false;
+
+    try{
+
+      _root.warnAll(true);
+
+    } catch(ParseException&){
+
+      _threw = true;
+
+    }
+
+    cerr.rdbuf(saved);
+
+    return captured.str();
+
+  }
+
+}
+
+int
+main(){
+
+  string filename = writeTemporary("children.xml",
+      "<r>\n"
+      "  <!-- before -->\n"
+      "  <a x=\"1\"/>\n"
+      "  <b><c/><!-- inside --><d/></b>\n"
+      "  <e/>\n"
+      "  <!-- after -->\n"
+      "</r>\n");
+
+  string mixed = writeTemporary("mixed.xml", "<r><a/>text<b/></r>");
+
+  {
+
+    XMLNode root(filename, "r");
+
+    CHECK(names(root) == "a b e ");
+
+    XMLNode::iterator b = root.findChild("b");
+
+    if(CHECK(b != root.end())){
+
+      CHECK(names(*b) == "c d ");
+
+      // the cursor reuses its view; a copy stays put
+      XMLNode kept = *b;
+      ++b;
+
+      CHECK(kept.name() == "b");
+      CHECK(b->name() == "e");
+
+    }
+
+    CHECK(root.findChild("missing") == root.end());
+
+    XMLNode::iterator a = root.findChild("a");
+    CHECK(a->begin() == a->end());
+
+    // a lookup that found nothing is a null node, which is fine to
+    // hold
+    XMLNode none(a->getFirstChild());
+    (void)none;
+
+    // nothing but a is read: b and e are reported, and so is the
+    // attribute of a nobody asked for
+    a->verify("a");
+
+    bool threw;
+    string report = warnings(root, threw);
+
+    CHECK(threw);
+    CHECK(report.find("Node: b") != string::npos);
+    CHECK(report.find("Node: e") != string::npos);
+    CHECK(report.find("Node: c") == string::npos);
+    CHECK(report.find("\tx\n") != string::npos);
+
+    // read everything and there is nothing to report
+    a->read("x", true, "", "x");
+
+    for(auto& child : root){
+
+      child.verify(child.name());
+
+      for(auto& grandchild : child)
+        grandchild.verify(grandchild.name());
+
+    }
+
+    report = warnings(root, threw);
+
+    CHECK(!threw);
+    CHECK(report.empty());
+
+  }
+
+  {
+
+    XMLNode root(mixed, "r");
+
+    bool threw = false;
+
+    try{
+
+      names(root);
+
+    } catch(ParseException&){
+
+      threw = true;
+
+    }
+
+    CHECK(threw);
+
+  }
+
+  remove(filename.c_str());
+  remove(mixed.c_str());
+
+  return testResult("test_children");
+
+}
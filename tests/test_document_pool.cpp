@@ -0,0 +1,121 @@
+#include <TestUtil.h>
+
+#include <memory>
+
+// the root XMLNode owns its document, shared with its copies, and a pool
+// takes documents back when the last of them lets go and hands them out
+// again, whatever outlives what
+
+namespace {
+
+  const uint64_t meshSceneHash = 0x1f9b5111e812a3f5ull;
+
+  string
+  names(XMLNode& _node){
+
+    string list;
+
+    for(auto& child : _node)
+      list += child.name() + " ";
+
+    return list;
+
+  }
+
+}
+
+int
+main(){
+
+  string first = writeTemporary("first.xml", "<r><a/><b/></r>");
+  string second = writeTemporary("second.xml", "<r><c/><d/><e/></r>");
+
+  // a copy keeps the document after the root it was made from is gone
+  {
+
+    unique_ptr<XMLNode> root(new XMLNode(first, "r"));
+    XMLNode copy = *root;
+
+    root.reset();
+
+    CHECK(copy.filename() == first);
+    CHECK(names(copy) == "a b ");
+
+  }
+
+  {
+
+    XMLDocumentPool pool(1);
+
+    XMLLoadOptions options;
+    options.pool = &pool;
+
+    size_t arenaBytes;
+
+    {
+
+      XMLNode root(first, "r", options);
+
+      CHECK(pool.size() == 0);
+      CHECK(names(root) == "a b ");
+
+      arenaBytes = root.loadStats().arenaBytes;
+
+    }
+
+    CHECK(pool.size() == 1);
+
+    {
+
+      // the same document, emptied and named for the new file
+      XMLNode root(second, "r", options);
+
+      CHECK(pool.size() == 0);
+      CHECK(root.filename() == second);
+      CHECK(names(root) == "c d e ");
+      CHECK(root.loadStats().arenaBytes > arenaBytes);
+
+      // a second document at the same time is a new one, and only one
+      // is kept
+      XMLNode other(first, "r", options);
+      CHECK(names(other) == "a b ");
+
+    }
+
+    CHECK(pool.size() == 1);
+
+    // a document may outlive its pool
+    unique_ptr<XMLDocumentPool> shortLived(new XMLDocumentPool(1));
+    options.pool = shortLived.get();
+
+    XMLNode root(first, "r", options);
+    shortLived.reset();
+
+    CHECK(names(root) == "a b ");
+
+  }
+
+  // loads through a pool read the scene a fresh document does
+  {
+
+    XMLDocumentPool pool;
+
+    ColladaLoader loader;
+    ColladaLoader::LoadOptions options;
+    options.xml.pool = &pool;
+
+    for(int load = 0; load < 3; load++){
+
+      CHECK(hashScene(loader.parseCollada(testData("mesh.dae"), "COLLADA", options)) == meshSceneHash);
+      CHECK(pool.size() == 1);
+
+    }
+
+  }
+
+  remove(first.c_str());
+  remove(second.c_str());
+
+  return testResult("test_document_pool");
+
+}
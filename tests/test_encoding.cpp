@@ -0,0 +1,70 @@
+#include <TestUtil.h>
+
+// the parser's character loops are compiled once per encoding; every
+// specialization must build the same tree from UTF-8 input
+
+namespace {
+
+  const char* document =
+      "\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+      "<r a=\"1 &amp; 2\" b='x&#65;y'>\r\n"
+      "  <e>caf\xc3\xa9 &lt;\xe2\x82\xac&gt; &#x42;</e>\n"
+      "  <!-- c -->\n"
+      "  <f><![CDATA[ <raw> ]]></f><g/>\n"
+      "  <h attr=\"\xc3\xa9\"> t\tu  v </h>\n"
+      "</r>\n";
+
+  const char* utf8Names =
+      "<r><\xc3\xa9l\xc3\xa9ment attr=\"\xc3\xa9\">x</\xc3\xa9l\xc3\xa9ment></r>";
+
+  string
+  print(const char* _document, TiXmlEncoding _encoding, bool _rawText){
+
+    TiXmlDocument doc;
+    doc.SetRawText(_rawText);
+    doc.Parse(_document, 0, _encoding);
+
+    if(doc.Error())
+      return string("error: ") + doc.ErrorDesc();
+
+    TiXmlPrinter printer;
+    doc.Accept(&printer);
+
+    return printer.Str();
+
+  }
+
+}
+
+int
+main(){
+
+  for(bool rawText : {false, true}){
+
+    string utf8 = print(document, TIXML_ENCODING_UTF8, rawText);
+
+    CHECK(utf8.compare(0, 6, "error:") != 0);
+    CHECK(print(document, TIXML_ENCODING_UNKNOWN, rawText) == utf8);
+    CHECK(utf8.find("caf\xc3\xa9 &lt;\xe2\x82\xac&gt; B") != string::npos);
+    CHECK(utf8.find("<![CDATA[ <raw> ]]>") != string::npos);
+    CHECK(utf8.find("<h attr=\"\xc3\xa9\">") != string::npos);
+
+    string names = print(utf8Names, TIXML_ENCODING_UTF8, rawText);
+
+    CHECK(names.find("<\xc3\xa9l\xc3\xa9ment attr=\"\xc3\xa9\">x</") != string::npos);
+    CHECK(print(utf8Names, TIXML_ENCODING_UNKNOWN, rawText) == names);
+
+#ifndef TIXML_UTF8_ONLY
+
+    // legacy input is read a byte at a time, to the same tree. a byte
+    // order mark means nothing to it; it never did
+    CHECK(print(document + 3, TIXML_ENCODING_LEGACY, rawText) == utf8);
+    CHECK(print(utf8Names, TIXML_ENCODING_LEGACY, rawText) == names);
+
+#endif
+
+  }
+
+  return testResult("test_encoding");
+
+}
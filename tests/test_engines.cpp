@@ -0,0 +1,94 @@
+#include <TestUtil.h>
+
+// the DOM engine, the streaming engine and pushed input must all read
+// the same scene, and the same one the loader read before either was
+// made faster
+
+namespace {
+
+  // the vertices of data/mesh.dae as the original loader read them
+  const uint64_t meshGeometryHash = 0x6201743dbb2d487eull;
+
+  // the whole scene as read now. the original took the index of
+  // refraction from the float read before it, 1 here, where it is 1.5
+  const uint64_t meshSceneHash = 0x1f9b5111e812a3f5ull;
+
+  ColladaLoader::Scene
+  load(const string& _filename, const ColladaLoader::LoadOptions& _options){
+
+    ColladaLoader loader;
+
+    return loader.parseCollada(_filename, "COLLADA", _options);
+
+  }
+
+  // pushes the file in pieces of _piece bytes, or of random sizes
+  // when _piece is 0
+  ColladaLoader::Scene
+  push(const string& _filename, size_t _piece){
+
+    string text = readFile(_filename);
+
+    ColladaLoader loader;
+    loader.begin(_filename);
+
+    srand(7);
+
+    for(size_t at = 0; at < text.size();){
+
+      size_t length = min(text.size() - at,
+          _piece ? _piece : 1 + size_t(rand()) % 512);
+
+      loader.feed(text.data() + at, length);
+      at += length;
+
+    }
+
+    return loader.finish();
+
+  }
+
+}
+
+int
+main(){
+
+  string mesh = testData("mesh.dae");
+
+  ColladaLoader::LoadOptions dom;
+
+  ColladaLoader::LoadOptions copied;
+  copied.xml.memoryMap = false;
+
+  ColladaLoader::LoadOptions streaming;
+  streaming.streaming = true;
+
+  ColladaLoader::Scene scene = load(mesh, dom);
+
+  CHECK(scene.geometries().size() == 1);
+  CHECK(scene.geometries()[0].polylistCollection.size() == 1);
+  CHECK(scene.geometries()[0].polylistCollection[0].vertexCollection.size() == 48);
+  CHECK(scene.materials().size() == 10);
+
+  CHECK(hashGeometries(scene) == meshGeometryHash);
+  CHECK(hashScene(scene) == meshSceneHash);
+
+  // every spec adds the material as read so far
+  const ColladaLoader::Material& material = scene.materials()[scene.materials().size() - 1];
+
+  CHECK(material.ambient == glm::vec4(0.1f, 0.2f, 0.3f, 1));
+  CHECK(material.diffuse == glm::vec4(0));
+  CHECK(material.specular == glm::vec4(0.5f, 0.5f, 0.5f, 1));
+  CHECK(material.shininess == 50);
+  CHECK(material.reflectivity == 0.25f);
+  CHECK(material.refractionIndex == 1.5f);
+
+  CHECK(hashScene(load(mesh, copied)) == meshSceneHash);
+  CHECK(hashScene(load(mesh, streaming)) == meshSceneHash);
+
+  CHECK(hashScene(push(mesh, 1)) == meshSceneHash);
+  CHECK(hashScene(push(mesh, 0)) == meshSceneHash);
+
+  return testResult("test_engines");
+
+}
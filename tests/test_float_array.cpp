@@ -0,0 +1,198 @@
+#include <TestUtil.h>
+
+#include <cmath>
+#include <random>
+
+// parseFloatArray must read every token as strtof reads it alone, in
+// the "C" locale, and stop where strtof would first fail
+
+namespace {
+
+  bool
+  isDelimiter(char _c){
+
+    return _c == ' ' || _c == '\n' || _c == '\t' || _c == '\r' ||
+           _c == '\v' || _c == '\f';
+
+  }
+
+  // the tokenizer parseFloatArray replaced, a token at a time
+  const char*
+  strtofArray(const char* _begin, const char* _end, vector<float>& _out){
+
+    while(true){
+
+      while(_begin != _end && isDelimiter(*_begin))
+        _begin++;
+
+      if(_begin == _end)
+        return _begin;
+
+      const char* tokenEnd = _begin;
+
+      while(tokenEnd != _end && !isDelimiter(*tokenEnd))
+        tokenEnd++;
+
+      string token(_begin, tokenEnd);
+      char* parsed;
+      float value = strtof(token.c_str(), &parsed);
+
+      if(parsed != token.c_str() + token.size())
+        return _begin;
+
+      _out.push_back(value);
+      _begin = tokenEnd;
+
+    }
+
+  }
+
+  const char* unusual[] = {
+    "INF", "-INF", "NaN", "nan", "inf", "+1", "+.5", "1.", "-.0", "-0", ".",
+    "1e", "1e+", "e5", "0x1p3", "1e40", "1e-50", "3.4028236e38", "1.4e-45",
+    "7e-46", "1x", "--1", "1e-", "0.000000000000000000000000000001234",
+    "123456789012345678901234567890", "1e-400",
+    "00000000000000000000000000001.5", "9007199254740993",
+    "1.00000005960464477539062500000000001"
+  };
+
+  string
+  randomToken(mt19937_64& _random){
+
+    char buffer[64];
+
+    switch(_random() % 6){
+
+      // a decimal, maybe with a point, an exponent and a sign
+      case 0:
+      case 1: {
+
+        string token;
+
+        for(int digits = 1 + _random() % 20; digits > 0; digits--)
+          token += char('0' + _random() % 10);
+
+        if(_random() % 2)
+          token.insert(_random() % (token.size() + 1), ".");
+
+        if(_random() % 3 == 0)
+          token += "e" + to_string(int(_random() % 80) - 40);
+
+        return _random() % 2 ? "-" + token : token;
+
+      }
+
+      // any float, printed in full or short
+      case 2: {
+
+        uint32_t bits = uint32_t(_random());
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+
+        snprintf(buffer, sizeof(buffer), _random() % 2 ? "%.9g" : "%.6g", value);
+        return buffer;
+
+      }
+
+      // halfway between two floats, where rounding is hardest
+      case 3: {
+
+        uint32_t bits = uint32_t(_random() % 0x7f000000);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+
+        double halfway = (double(value) + double(nextafterf(value, INFINITY))) / 2;
+
+        snprintf(buffer, sizeof(buffer), "%.17g", halfway);
+        return buffer;
+
+      }
+
+      case 4:
+        return unusual[_random() % (sizeof(unusual) / sizeof(unusual[0]))];
+
+      // anything made of number characters
+      default: {
+
+        string token;
+
+        for(int length = 1 + _random() % 30; length > 0; length--)
+          token += "0123456789.eE-+"[_random() % 15];
+
+        return token;
+
+      }
+
+    }
+
+  }
+
+}
+
+int
+main(){
+
+  mt19937_64 random(18);
+
+  for(int text = 0; text < 3000; text++){
+
+    string input;
+
+    for(int tokens = random() % 200; tokens > 0; tokens--){
+
+      input += randomToken(random);
+
+      for(int delimiters = 1 + random() % 3; delimiters > 0; delimiters--)
+        input += " \n\t\r\v\f"[random() % 6];
+
+      // past the block the delimiters are looked for in
+      if(random() % 50 == 0)
+        input += string(random() % 130, ' ');
+
+    }
+
+    const char* begin = input.data();
+    const char* end = begin + input.size();
+
+    vector<float> expected;
+    const char* expectedStop = strtofArray(begin, end, expected);
+
+    // converted in pieces of random capacity, as the loader fills
+    // arrays it couldn't size beforehand
+    vector<float> parsed;
+    const char* stop = begin;
+    size_t capacity = 1 + random() % 20;
+
+    while(true){
+
+      size_t size = parsed.size();
+      size_t count;
+
+      parsed.resize(size + capacity);
+      stop = parseFloatArray(stop, end, parsed.data() + size, capacity, count);
+      parsed.resize(size + count);
+
+      if(count < capacity)
+        break;
+
+    }
+
+    // bit for bit, so NaNs compare too; data() of an empty vector may
+    // be null, which memcmp must not be given
+    bool same = parsed.size() == expected.size() && (parsed.empty() ||
+        memcmp(parsed.data(), expected.data(), parsed.size() * sizeof(float)) == 0);
+
+    if(!CHECK(same && stop == expectedStop)){
+
+      printf("  text %d: %zu values, %zu expected; stopped at %ld, %ld expected\n",
+             text, parsed.size(), expected.size(), long(stop - begin),
+             long(expectedStop - begin));
+      break;
+
+    }
+
+  }
+
+  return testResult("test_float_array");
+
+}
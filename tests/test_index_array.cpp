@@ -0,0 +1,154 @@
+#include <TestUtil.h>
+
+#include <random>
+
+// parseIndexArray must read what a plain loop over the digits of each
+// token reads, and stop at the first token that isn't an index or
+// doesn't fit
+
+namespace {
+
+  bool
+  isDelimiter(char _c){
+
+    return _c == ' ' || _c == '\n' || _c == '\t' || _c == '\r' ||
+           _c == '\v' || _c == '\f';
+
+  }
+
+  // a character at a time
+  template<typename T>
+    const char*
+    scalarIndexArray(const char* _begin, const char* _end, vector<T>& _out){
+
+      while(true){
+
+        while(_begin != _end && isDelimiter(*_begin))
+          _begin++;
+
+        if(_begin == _end)
+          return _begin;
+
+        const char* p = _begin;
+        T value = 0;
+
+        for(; p != _end && !isDelimiter(*p); p++){
+
+          if(*p < '0' || *p > '9')
+            return _begin;
+
+          T digit = T(*p - '0');
+
+          if(value > (numeric_limits<T>::max() - digit) / 10)
+            return _begin;
+
+          value = value * 10 + digit;
+
+        }
+
+        _out.push_back(value);
+        _begin = p;
+
+      }
+
+    }
+
+  string
+  randomToken(mt19937_64& _random){
+
+    switch(_random() % 20){
+
+      // a vertex of a mesh with a few hundred thousand
+      default:
+        return to_string(_random() % 100000);
+
+      case 15:
+        return to_string(_random());
+
+      // around the largest 32 and 64 bit values
+      case 16:
+        return to_string(_random() % 3 ? 4294967295ull + _random() % 3 - 1 :
+                                         18446744073709551615ull);
+
+      case 17:
+        return string(_random() % 25, '0') + "7";
+
+      // signs, points and exponents are not indices
+      case 18:
+        return string("-1 +2 1.0 x 1e3").substr(_random() % 12, 3);
+
+      // too many digits for anything
+      case 19:
+        return to_string(_random() % 10) + string(_random() % 70, '9');
+
+    }
+
+  }
+
+  template<typename T>
+    void
+    compare(mt19937_64& _random, int _texts){
+
+      for(int text = 0; text < _texts; text++){
+
+        string input;
+
+        for(int tokens = _random() % 200; tokens > 0; tokens--){
+
+          input += randomToken(_random);
+
+          for(int delimiters = 1 + _random() % 3; delimiters > 0; delimiters--)
+            input += " \n\t\r\v\f"[_random() % 6];
+
+        }
+
+        const char* begin = input.data();
+        const char* end = begin + input.size();
+
+        vector<T> expected;
+        const char* expectedStop = scalarIndexArray(begin, end, expected);
+
+        vector<T> parsed;
+        const char* stop = begin;
+        size_t capacity = 1 + _random() % 20;
+
+        while(true){
+
+          size_t size = parsed.size();
+          size_t count;
+
+          parsed.resize(size + capacity);
+          stop = parseIndexArray(stop, end, parsed.data() + size, capacity, count);
+          parsed.resize(size + count);
+
+          if(count < capacity)
+            break;
+
+        }
+
+        if(!CHECK(parsed == expected && stop == expectedStop)){
+
+          printf("  %zu bit text %d: %zu values, %zu expected; stopped at %ld, %ld expected\n",
+                 sizeof(T) * 8, text, parsed.size(), expected.size(),
+                 long(stop - begin), long(expectedStop - begin));
+          return;
+
+        }
+
+      }
+
+    }
+
+}
+
+int
+main(){
+
+  mt19937_64 random(19);
+
+  compare<uint32_t>(random, 3000);
+  compare<uint64_t>(random, 3000);
+
+  return testResult("test_index_array");
+
+}
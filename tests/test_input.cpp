@@ -0,0 +1,272 @@
+#include <TestUtil.h>
+
+#include <csignal>
+#include <thread>
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include <XMLStreamParser.h>
+
+// files can be gzip compressed, and can be pipes that can't be sized or
+// sought in; every way in must read the same scene
+
+namespace {
+
+  // as in test_engines
+  const uint64_t meshSceneHash = 0x1f9b5111e812a3f5ull;
+
+  // a member per piece of _text; gzip readers go on to the next
+  string
+  gzip(const string& _text, size_t _members){
+
+    string compressed;
+
+    for(size_t m = 0; m < _members; m++){
+
+      size_t begin = _text.size() * m / _members;
+      size_t end = _text.size() * (m + 1) / _members;
+
+      z_stream stream = z_stream();
+      deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS,
+                   8, Z_DEFAULT_STRATEGY);
+
+      string member(deflateBound(&stream, end - begin), '\0');
+
+      stream.next_in = (Bytef*)_text.data() + begin;
+      stream.avail_in = uInt(end - begin);
+      stream.next_out = (Bytef*)&member[0];
+      stream.avail_out = uInt(member.size());
+
+      deflate(&stream, Z_FINISH);
+      member.resize(stream.total_out);
+      deflateEnd(&stream);
+
+      compressed += member;
+
+    }
+
+    return compressed;
+
+  }
+
+  // _text written into a pipe by a thread of its own while the read
+  // end is used, by name or by descriptor
+  class Pipe {
+
+    public:
+
+      Pipe(const string& _text){
+
+        int fds[2];
+
+        if(pipe(fds) != 0){
+
+          m_read = m_write = -1;
+          return;
+
+        }
+
+        m_read = fds[0];
+        m_write = fds[1];
+
+        m_writer = thread([this, _text](){
+
+          for(size_t at = 0; at < _text.size();){
+
+            ssize_t written = write(m_write, _text.data() + at, _text.size() - at);
+
+            if(written <= 0)
+              break;
+
+            at += written;
+
+          }
+
+          close(m_write);
+
+        });
+
+      }
+
+      ~Pipe(){
+
+        if(m_read >= 0){
+
+          // whatever was left unread
+          close(m_read);
+          m_writer.join();
+
+        }
+
+      }
+
+      string
+      name() const {
+
+        return "/dev/fd/" + to_string(m_read);
+
+      }
+
+      int
+      readEnd() const {
+
+        return m_read;
+
+      }
+
+    private:
+
+      int m_read;
+      int m_write;
+      thread m_writer;
+
+  };
+
+  ColladaLoader::Scene
+  loadScene(const string& _filename, bool _streaming){
+
+    ColladaLoader loader;
+    ColladaLoader::LoadOptions options;
+    options.streaming = _streaming;
+
+    return loader.parseCollada(_filename, "COLLADA", options);
+
+  }
+
+  // 0 when the load fails
+  uint64_t
+  load(const string& _filename, bool _streaming){
+
+    try{
+
+      return hashScene(loadScene(_filename, _streaming));
+
+    } catch(ParseException& _exception){
+
+      printf("%s", _exception.what());
+      return 0;
+
+    }
+
+  }
+
+  bool
+  loadFails(const string& _filename, bool _streaming){
+
+    try{
+
+      loadScene(_filename, _streaming);
+
+    } catch(ParseException&){
+
+      return true;
+
+    }
+
+    return false;
+
+  }
+
+}
+
+int
+main(){
+
+  string text = readFile(testData("mesh.dae"));
+
+  // a pipe closed before it is read to the end fails the write instead
+  signal(SIGPIPE, SIG_IGN);
+
+  // the first two bytes of a file decide whether it's compressed, so
+  // these cover every combination of mapped, copied and piped input
+  string compressedText = gzip(text, 1);
+
+  string plain = writeTemporary("plain.dae", text);
+  string compressed = writeTemporary("compressed.dae.gz", compressedText);
+  string members = writeTemporary("members.dae.gz", gzip(text, 3));
+  string truncated = writeTemporary("truncated.dae.gz",
+      compressedText.substr(0, compressedText.size() / 2));
+
+  for(bool streaming : {false, true}){
+
+    ColladaLoader::Scene scene = loadScene(compressed, streaming);
+
+    CHECK(hashScene(scene) == meshSceneHash);
+    CHECK(scene.stats().bytesRead == text.size());
+    CHECK(scene.stats().compressedBytes == compressedText.size());
+
+    CHECK(load(members, streaming) == meshSceneHash);
+    CHECK(loadFails(truncated, streaming));
+
+    {
+
+      Pipe pipe(text);
+      CHECK(load(pipe.name(), streaming) == meshSceneHash);
+
+    }
+
+    {
+
+      Pipe pipe(compressedText);
+      CHECK(load(pipe.name(), streaming) == meshSceneHash);
+
+    }
+
+  }
+
+  // the tree tinyxml reads from the plain file
+  TiXmlDocument fromFile;
+  CHECK(fromFile.LoadFile(plain.c_str()));
+
+  TiXmlPrinter expected;
+  fromFile.Accept(&expected);
+
+  // tinyxml and the streaming parser decompress as they read
+  for(const string& filename : {compressed, members}){
+
+    TiXmlDocument fromGzip;
+    CHECK(fromGzip.LoadFile(filename.c_str()));
+    CHECK(fromGzip.LoadStats().bytesRead == text.size());
+    CHECK(fromGzip.LoadStats().compressedBytes == readFile(filename).size());
+
+    TiXmlPrinter printer;
+    fromGzip.Accept(&printer);
+
+    CHECK(printer.Str() == expected.Str());
+
+    XMLStreamHandler ignore;
+    XMLStreamParser parser(ignore, filename);
+    parser.parseFile(filename);
+
+    CHECK(parser.bytesRead() == text.size());
+    CHECK(parser.compressedBytes() == readFile(filename).size());
+
+  }
+
+  TiXmlDocument fromTruncated;
+  CHECK(!fromTruncated.LoadFile(truncated.c_str()));
+
+  // tinyxml reads a FILE* it can't seek in to the end
+  {
+
+    Pipe pipe(text);
+    FILE* file = fdopen(dup(pipe.readEnd()), "rb");
+
+    TiXmlDocument fromPipe;
+    CHECK(fromPipe.LoadFile(file));
+    fclose(file);
+
+    TiXmlPrinter printer;
+    fromPipe.Accept(&printer);
+
+    CHECK(printer.Str() == expected.Str());
+
+  }
+
+  for(const string& filename : {plain, compressed, members, truncated})
+    remove(filename.c_str());
+
+  return testResult("test_input");
+
+}
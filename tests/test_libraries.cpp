@@ -0,0 +1,114 @@
+#include <TestUtil.h>
+
+// the libraries a load doesn't ask for, and everything else at the top
+// level, are passed over unparsed by every engine, and what is read
+// comes out as in a full load
+
+namespace {
+
+  enum Engine {Dom, Streaming, Push};
+
+  ColladaLoader::Scene
+  load(const string& _filename, Engine _engine, unsigned _libraries){
+
+    ColladaLoader loader;
+    ColladaLoader::LoadOptions options;
+    options.streaming = _engine == Streaming;
+    options.libraries = _libraries;
+
+    if(_engine != Push)
+      return loader.parseCollada(_filename, "COLLADA", options);
+
+    string text = readFile(_filename);
+
+    loader.begin(_filename, options);
+    loader.feed(text.data(), text.size());
+
+    return loader.finish();
+
+  }
+
+  // the length of the first element called _name in _text
+  size_t
+  elementSize(const string& _text, const string& _name){
+
+    size_t begin = _text.find("<" + _name);
+    size_t end = _text.find("</" + _name + ">");
+
+    return end + _name.size() + 3 - begin;
+
+  }
+
+}
+
+int
+main(){
+
+  typedef ColladaLoader::LoadOptions Options;
+
+  string mesh = testData("mesh.dae");
+  string text = readFile(mesh);
+
+  ColladaLoader::Scene full = load(mesh, Dom, Options::Geometries | Options::Effects);
+
+  size_t effectsSize = elementSize(text, "library_effects");
+  size_t geometriesSize = elementSize(text, "library_geometries");
+  size_t skippedAlways = full.stats().bytesSkipped;
+
+  // mesh.dae has an asset and libraries no load reads
+  CHECK(skippedAlways > 0);
+
+  for(Engine engine : {Dom, Streaming, Push}){
+
+    ColladaLoader::Scene scene = load(mesh, engine, Options::Geometries | Options::Effects);
+
+    CHECK(hashScene(scene) == hashScene(full));
+    CHECK(scene.stats().bytesSkipped == skippedAlways);
+
+    scene = load(mesh, engine, Options::Geometries);
+
+    CHECK(hashGeometries(scene) == hashGeometries(full));
+    CHECK(scene.materials().empty());
+    CHECK(scene.stats().bytesSkipped == skippedAlways + effectsSize);
+
+    scene = load(mesh, engine, Options::Effects);
+
+    CHECK(scene.geometries().empty());
+    CHECK(hashScene(scene) == hashScene(load(mesh, Dom, Options::Effects)));
+    CHECK(scene.materials().size() == full.materials().size());
+    CHECK(scene.stats().bytesSkipped == skippedAlways + geometriesSize);
+
+    scene = load(mesh, engine, 0);
+
+    CHECK(scene.geometries().empty());
+    CHECK(scene.materials().empty());
+    CHECK(scene.stats().bytesSkipped == skippedAlways + effectsSize + geometriesSize);
+
+  }
+
+  // what is skipped isn't checked, only scanned for its end
+  string polylists = readFile(testData("polylists.dae"));
+  string unread = "<library_visual_scenes><node a=1/>&bogus;</library_visual_scenes>";
+
+  string withUnread = polylists;
+  withUnread.insert(withUnread.find("</COLLADA>"), unread);
+
+  string filename = writeTemporary("unread.dae", withUnread);
+
+  uint64_t expected = hashScene(load(testData("polylists.dae"), Dom,
+                                     Options::Geometries | Options::Effects));
+
+  for(Engine engine : {Dom, Streaming, Push}){
+
+    ColladaLoader::Scene scene = load(filename, engine, Options::Geometries | Options::Effects);
+
+    CHECK(hashScene(scene) == expected);
+    CHECK(scene.stats().bytesSkipped == unread.size());
+
+  }
+
+  remove(filename.c_str());
+
+  return testResult("test_libraries");
+
+}
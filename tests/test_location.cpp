@@ -0,0 +1,121 @@
+#include <TestUtil.h>
+
+// without exact locations, rows are still exact for '\n' line breaks and
+// so are columns for ASCII without tabs; tabs and multi-byte characters
+// only move the column, and a parse error is located exactly either way
+
+namespace {
+
+  // the row and column of every node, in document order
+  void
+  locations(const TiXmlNode* _node, vector<pair<int, int>>& _list){
+
+    _list.push_back(make_pair(_node->Row(), _node->Column()));
+
+    for(const TiXmlNode* child = _node->FirstChild(); child; child = child->NextSibling())
+      locations(child, _list);
+
+  }
+
+  vector<pair<int, int>>
+  locations(const TiXmlDocument& _doc){
+
+    vector<pair<int, int>> list;
+
+    for(const TiXmlNode* child = _doc.FirstChild(); child; child = child->NextSibling())
+      locations(child, list);
+
+    return list;
+
+  }
+
+  vector<pair<int, int>>
+  locations(const string& _text, bool _exact){
+
+    TiXmlDocument doc;
+    doc.SetExactLocation(_exact);
+    doc.Parse(_text.c_str(), 0, TIXML_ENCODING_UTF8);
+
+    return locations(doc);
+
+  }
+
+  // ErrorRow and ErrorCol of parsing _text
+  pair<int, int>
+  errorAt(const string& _text, bool _exact){
+
+    TiXmlDocument doc;
+    doc.SetExactLocation(_exact);
+    doc.Parse(_text.c_str(), 0, TIXML_ENCODING_UTF8);
+
+    return doc.Error() ? make_pair(doc.ErrorRow(), doc.ErrorCol()) : make_pair(0, 0);
+
+  }
+
+}
+
+int
+main(){
+
+  // plain ASCII: the same everywhere
+  string ascii =
+      "<?xml version=\"1.0\"?>\n"
+      "<r a=\"1\">\n"
+      "  <!-- a comment -->\n"
+      "  <b>some text</b><c/>\n"
+      "\n"
+      "    <d>\n"
+      "      <e x=\"y\"/>   <f/>\n"
+      "    </d>\n"
+      "</r>\n";
+
+  vector<pair<int, int>> exact = locations(ascii, true);
+
+  CHECK(exact.size() == 9);
+  CHECK(locations(ascii, false) == exact);
+
+  // a tab counts as one column and é as two, on their own line only
+  string special =
+      "<r>\n"
+      "\t<a/>\n"
+      "<b x=\"\xc3\xa9\"/><c/>\n"
+      "<d/>\n"
+      "</r>\n";
+
+  exact = locations(special, true);
+  vector<pair<int, int>> cheap = locations(special, false);
+
+  // r, a, b, c, d
+  CHECK(exact == (vector<pair<int, int>>{{1, 1}, {2, 5}, {3, 1}, {3, 11}, {4, 1}}));
+  CHECK(cheap == (vector<pair<int, int>>{{1, 1}, {2, 2}, {3, 1}, {3, 12}, {4, 1}}));
+
+  // errors are where they are, whatever came before them
+  for(const string& text : {special + "<e>\t\xc3\xa9</f>",
+                            special + "\n\t<g a=\"\xc3\xa9\" \xc3\xa9/>",
+                            string("\t<r>\n\xc3\xa9\xc3\xa9<x>\n\t\t<y></x>")}){
+
+    pair<int, int> error = errorAt(text, true);
+
+    if(!CHECK(error.first > 1))
+      printf("  no error in \"%s\"\n", text.c_str());
+
+    CHECK(errorAt(text, false) == error);
+
+  }
+
+  // a loaded file, the way the loader reads it
+  TiXmlDocument exactDoc(testData("mesh.dae").c_str());
+  exactDoc.LoadFile();
+
+  TiXmlDocument cheapDoc(testData("mesh.dae").c_str());
+  cheapDoc.SetExactLocation(false);
+  cheapDoc.LoadFile();
+
+  exact = locations(exactDoc);
+
+  CHECK(exact.size() > 10);
+  CHECK(locations(cheapDoc) == exact);
+
+  return testResult("test_location");
+
+}
@@ -0,0 +1,241 @@
+#include <TestUtil.h>
+
+#include <cerrno>
+#include <clocale>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// attributes are converted by parseNumber instead of streams: the same
+// values strtol and strtod give, the same text refused, and no locale
+
+namespace {
+
+  // _text converted whole, or false
+  template<typename T>
+    bool
+    number(const string& _text, T& _value){
+
+      return parseNumber(_text.data(), _text.data() + _text.size(), _value) ==
+          _text.data() + _text.size();
+
+    }
+
+  // every integer type against strtoll and strtoull, around its limits
+  template<typename T>
+    void
+    checkIntegers(){
+
+      typedef numeric_limits<T> Limits;
+
+      vector<string> texts = {"0", "1", "-1", "-0", "7", "10", "0010", "-",
+                              "", "+1", " 1", "1 ", "x", "1x"};
+
+      for(long long delta : {-1, 0, 1}){
+
+        texts.push_back(to_string((long long)Limits::min() + delta));
+        texts.push_back(to_string((unsigned long long)Limits::max() + delta));
+
+      }
+
+      texts.push_back("18446744073709551616");
+      texts.push_back("-9223372036854775809");
+      texts.push_back("99999999999999999999999");
+
+      for(const string& text : texts){
+
+        T value = 42;
+        bool converted = number(text, value);
+
+        // what strtoll or strtoull accepts as a whole, within range
+        bool fits = !text.empty() && isdigit((unsigned char)text.back()) &&
+            (isdigit((unsigned char)text[0]) || (text[0] == '-' && Limits::is_signed));
+
+        if(fits){
+
+          errno = 0;
+          char* end;
+
+          if(Limits::is_signed){
+
+            long long reference = strtoll(text.c_str(), &end, 10);
+            fits = errno == 0 && reference >= (long long)Limits::min() &&
+                reference <= (long long)Limits::max();
+
+            if(fits)
+              CHECK(!converted || (long long)value == reference);
+
+          } else{
+
+            unsigned long long reference = strtoull(text.c_str(), &end, 10);
+            fits = errno == 0 && reference <= (unsigned long long)Limits::max();
+
+            if(fits)
+              CHECK(!converted || (unsigned long long)value == reference);
+
+          }
+
+        }
+
+        if(!CHECK(converted == fits))
+          printf("  \"%s\" as a %zu byte %s integer\n", text.c_str(), sizeof(T),
+                 Limits::is_signed ? "signed" : "unsigned");
+
+        // nothing is written when there is no number at all
+        value = 42;
+
+        if(!parseNumber(text.data(), text.data() + text.size(), value))
+          CHECK(value == 42);
+
+      }
+
+      // a number is taken up to the first character that can't continue it
+      string text = "12,3";
+      T value = 0;
+      CHECK(parseNumber(text.data(), text.data() + text.size(), value) == text.data() + 2);
+      CHECK(value == 12);
+
+    }
+
+  void
+  checkFloats(){
+
+    mt19937 random(12);
+
+    for(int i = 0; i < 20000; i++){
+
+      // all sorts of bit patterns, printed as printf would
+      uint32_t bits = random();
+      float reference;
+      memcpy(&reference, &bits, sizeof(float));
+
+      if(!isfinite(reference))
+        continue;
+
+      char text[64];
+      snprintf(text, sizeof(text), i % 2 ? "%.9g" : "%.3e", reference);
+
+      float value;
+
+      if(!CHECK(number(text, value)))
+        continue;
+
+      CHECK(value == strtof(text, nullptr));
+
+      double precise;
+      CHECK(number(text, precise) && precise == strtod(text, nullptr));
+
+    }
+
+    float value;
+
+    CHECK(number("inf", value) && value == numeric_limits<float>::infinity());
+    CHECK(number("-inf", value) && value == -numeric_limits<float>::infinity());
+    CHECK(number("nan", value) && isnan(value));
+    CHECK(number("-0", value) && value == 0 && signbit(value));
+    CHECK(number(".5", value) && value == 0.5f);
+    CHECK(number("1e-40", value) && value > 0);
+
+    // out of range either way, and text strtof would take but
+    // from_chars wouldn't
+    for(const char* text : {"1e39", "-1e39", "1e-50", "0x10", "+1", " 1", "",
+                            "-", ".", "e5", "1,5"}){
+
+      CHECK(!number(text, value));
+
+      value = 42;
+
+      if(!parseNumber(text, text + strlen(text), value))
+        CHECK(value == 42);
+
+    }
+
+    double precise;
+    CHECK(number("1e39", precise) && precise == 1e39);
+    CHECK(!number("1e309", precise));
+
+  }
+
+  ////////////////////////////////////////////////////////////////////////
+
+  // reads attribute _name of the root of _filename into _value;
+  // false if that throws
+  template<typename T>
+    bool
+    readAttribute(const string& _filename, const string& _name, T& _value,
+                  T _min, T _max){
+
+      XMLNode root(_filename, "r");
+
+      try{
+
+        _value = root.read<T>(_name, true, T(), _min, _max, _name);
+        return true;
+
+      } catch(ParseException&){
+
+        return false;
+
+      }
+
+    }
+
+}
+
+int
+main(){
+
+  checkIntegers<int8_t>();
+  checkIntegers<uint8_t>();
+  checkIntegers<int16_t>();
+  checkIntegers<uint16_t>();
+  checkIntegers<int>();
+  checkIntegers<unsigned>();
+  checkIntegers<long long>();
+  checkIntegers<unsigned long long>();
+
+  checkFloats();
+
+  // attributes may have white space around the number, nothing else
+  int i;
+  CHECK(parseAttribute(" 12\t", i) && i == 12);
+  CHECK(!parseAttribute("12 13", i));
+  CHECK(!parseAttribute("12px", i));
+  CHECK(!parseAttribute("", i));
+
+  double d;
+  CHECK(parseAttribute("\n-2.5e3 ", d) && d == -2500);
+  CHECK(!parseAttribute("2,5", d));
+
+  // other types still go through a stream
+  string s;
+  CHECK(parseAttribute("word", s) && s == "word");
+
+  // and none of it follows the locale's decimal point
+  if(setlocale(LC_NUMERIC, "de_DE.UTF-8") || setlocale(LC_NUMERIC, "fr_FR.UTF-8")){
+
+    CHECK(parseAttribute("2.5", d) && d == 2.5);
+    CHECK(!parseAttribute("2,5", d));
+    setlocale(LC_NUMERIC, "C");
+
+  }
+
+  string filename = writeTemporary("attributes.xml",
+      "<r count=\"7\" big=\"300\" scale=\"0.25\" bad=\"7x\"/>");
+
+  float f;
+
+  CHECK(readAttribute(filename, "count", i, 0, 10) && i == 7);
+  CHECK(!readAttribute(filename, "count", i, 0, 5));
+  CHECK(!readAttribute(filename, "bad", i, 0, 10));
+  CHECK(!readAttribute(filename, "missing", i, 0, 10));
+  CHECK(readAttribute(filename, "scale", f, 0.f, 1.f) && f == 0.25f);
+
+  uint8_t small;
+  CHECK(!readAttribute<uint8_t>(filename, "big", small, 0, 255));
+
+  remove(filename.c_str());
+
+  return testResult("test_numbers");
+
+}
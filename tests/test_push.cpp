@@ -0,0 +1,114 @@
+#include <TestUtil.h>
+
+// begin, feed and finish read the scene parseCollada reads, however the
+// input is split, and refuse to be called out of order
+
+namespace {
+
+  const uint64_t meshSceneHash = 0x1f9b5111e812a3f5ull;
+
+  // feeds _text in the pieces that start at _cuts
+  ColladaLoader::Scene
+  push(ColladaLoader& _loader, const string& _text, const vector<size_t>& _cuts,
+       const ColladaLoader::LoadOptions& _options = ColladaLoader::LoadOptions()){
+
+    _loader.begin("pushed", _options);
+
+    size_t at = 0;
+
+    for(size_t cut : _cuts){
+
+      _loader.feed(_text.data() + at, cut - at);
+      at = cut;
+
+    }
+
+    _loader.feed(_text.data() + at, _text.size() - at);
+
+    return _loader.finish();
+
+  }
+
+  template<typename Exception, typename Call>
+    bool
+    throws(Call _call){
+
+      try{
+
+        _call();
+
+      } catch(Exception&){
+
+        return true;
+
+      }
+
+      return false;
+
+    }
+
+}
+
+int
+main(){
+
+  string text = readFile(testData("mesh.dae"));
+
+  ColladaLoader loader;
+
+  // split inside the declaration, a tag, an attribute, an entity-free
+  // array and right at the end, with empty pieces between
+  vector<size_t> cuts = {3, 3, text.find("<float_array") + 5,
+                         text.find("count=\"") + 3,
+                         text.find("</float_array>") - 7,
+                         text.size() - 1, text.size()};
+
+  ColladaLoader::Scene scene = push(loader, text, cuts);
+
+  CHECK(hashScene(scene) == meshSceneHash);
+  CHECK(scene.stats().bytesRead == text.size());
+
+  // and every single split point
+  for(size_t cut = 0; cut <= text.size(); cut++)
+    if(!CHECK(hashScene(push(loader, text, {cut})) == meshSceneHash))
+      break;
+
+  // with the options parseCollada takes
+  ColladaLoader::LoadOptions indexed;
+  indexed.indexed = true;
+  indexed.separateArrays = true;
+
+  CHECK(hashScene(push(loader, text, cuts, indexed)) ==
+        hashScene(loader.parseCollada(testData("mesh.dae"), "COLLADA", indexed)));
+
+  // begin() starts over whatever was fed before
+  loader.begin("abandoned");
+  loader.feed(text.data(), text.size() / 2);
+
+  CHECK(hashScene(push(loader, text, {})) == meshSceneHash);
+
+  // out of order
+  ColladaLoader fresh;
+
+  CHECK(throws<RunTimeException>([&]{fresh.feed(text.data(), 1);}));
+  CHECK(throws<RunTimeException>([&]{fresh.finish();}));
+
+  push(fresh, text, {});
+  CHECK(throws<RunTimeException>([&]{fresh.feed(text.data(), 1);}));
+
+  // input that ends early, or is malformed, fails; the load is over
+  // then, and the next begin() works as ever
+  fresh.begin();
+  fresh.feed(text.data(), text.size() / 2);
+
+  CHECK(throws<ParseException>([&]{fresh.finish();}));
+  CHECK(throws<RunTimeException>([&]{fresh.finish();}));
+
+  fresh.begin();
+  CHECK(throws<ParseException>([&]{fresh.feed("<COLLADA></asset>", 17);}));
+
+  CHECK(hashScene(push(fresh, text, cuts)) == meshSceneHash);
+
+  return testResult("test_push");
+
+}
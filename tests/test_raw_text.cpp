@@ -0,0 +1,90 @@
+#include <TestUtil.h>
+
+// with raw text on, text without entities is stored exactly as it is in
+// the input; text with entities, and CDATA, are read as before
+
+namespace {
+
+  const uint64_t meshSceneHash = 0x1f9b5111e812a3f5ull;
+
+  // the text of every element child of the root
+  vector<string>
+  texts(const string& _document, bool _rawText, size_t* _rawTextBytes = nullptr){
+
+    TiXmlDocument doc;
+    doc.SetRawText(_rawText);
+    doc.Parse(_document.c_str());
+
+    CHECK(!doc.Error());
+
+    if(_rawTextBytes)
+      *_rawTextBytes = doc.LoadStats().rawTextBytes;
+
+    vector<string> result;
+
+    for(const TiXmlElement* e = doc.RootElement()->FirstChildElement(); e;
+        e = e->NextSiblingElement())
+      result.push_back(e->GetText() ? e->GetText() : "");
+
+    return result;
+
+  }
+
+}
+
+int
+main(){
+
+  string document =
+      "<r>"
+      "<a>plain</a>"
+      "<b>  lead and  inner\t\ttabs \n trail \n</b>"
+      "<c>1 2\n3\r\n4</c>"
+      "<d>  with &amp;  entity </d>"
+      "<e><![CDATA[  cdata  ]]></e>"
+      "<f></f>"
+      "</r>";
+
+  size_t rawTextBytes;
+  vector<string> raw = texts(document, true, &rawTextBytes);
+
+  // leading white space is skipped either way, the rest kept; Parse,
+  // unlike LoadFile, doesn't turn \r\n into \n
+  vector<string> expected = {"plain", "lead and  inner\t\ttabs \n trail \n",
+                             "1 2\n3\r\n4", "with & entity", "  cdata  ", ""};
+
+  CHECK(raw == expected);
+
+  size_t verbatim = 0;
+
+  for(size_t i = 0; i < 3; i++)
+    verbatim += expected[i].size();
+
+  CHECK(rawTextBytes == verbatim);
+
+  // without raw text it is condensed
+  size_t condensedRawBytes;
+  vector<string> condensed = texts(document, false, &condensedRawBytes);
+
+  CHECK(condensed == vector<string>({"plain", "lead and inner tabs trail",
+                                     "1 2 3 4", "with & entity", "  cdata  ", ""}));
+  CHECK(condensedRawBytes == 0);
+
+  for(bool rawText : {false, true}){
+
+    TiXmlDocument doc;
+    doc.SetRawText(rawText);
+
+    CHECK(doc.LoadFile(testData("mesh.dae")));
+    CHECK((doc.LoadStats().rawTextBytes > 0) == rawText);
+
+  }
+
+  // the loader reads with raw text on, and numbers come out alike
+  // whatever white space is between them
+  ColladaLoader loader;
+  CHECK(hashScene(loader.parseCollada(testData("mesh.dae"), "COLLADA")) == meshSceneHash);
+
+  return testResult("test_raw_text");
+
+}
@@ -0,0 +1,108 @@
+#include <TestUtil.h>
+
+// one loader used for load after load must read every file as a new
+// loader would; nothing of one load may leak into the next
+
+namespace {
+
+  // as in test_engines
+  const uint64_t meshSceneHash = 0x1f9b5111e812a3f5ull;
+
+  enum Engine {Dom, Streaming, Push};
+
+  ColladaLoader::Scene
+  load(ColladaLoader& _loader, const string& _filename, Engine _engine){
+
+    ColladaLoader::LoadOptions options;
+    options.streaming = _engine == Streaming;
+
+    if(_engine != Push)
+      return _loader.parseCollada(_filename, "COLLADA", options);
+
+    string text = readFile(_filename);
+
+    _loader.begin(_filename, options);
+    _loader.feed(text.data(), text.size());
+
+    return _loader.finish();
+
+  }
+
+  ColladaLoader::Scene
+  loadFresh(const string& _filename, Engine _engine){
+
+    ColladaLoader loader;
+
+    return load(loader, _filename, _engine);
+
+  }
+
+}
+
+int
+main(){
+
+  string mesh = testData("mesh.dae");
+  string polylists = testData("polylists.dae");
+
+  for(Engine engine : {Dom, Streaming, Push}){
+
+    ColladaLoader loader;
+
+    ColladaLoader::Scene first = load(loader, mesh, engine);
+    ColladaLoader::Scene second = load(loader, mesh, engine);
+
+    CHECK(hashScene(first) == meshSceneHash);
+    CHECK(hashScene(second) == meshSceneHash);
+    CHECK(second.geometries().size() == 1);
+    CHECK(second.materials().size() == first.materials().size());
+    CHECK(second.stats().bytesRead == first.stats().bytesRead);
+
+    // a file with other materials, and polylists with a different
+    // number of inputs and offsets
+    ColladaLoader::Scene other = load(loader, polylists, engine);
+
+    CHECK(hashScene(other) == hashScene(loadFresh(polylists, engine)));
+    CHECK(other.stats().bytesRead == readFile(polylists).size());
+
+    // the lambert sets the diffuse color alone; the shininess of
+    // mesh.dae must not carry over
+    CHECK(other.materials().size() == 1);
+    CHECK(other.materials()[0].diffuse == glm::vec4(0.5f, 0.25f, 0, 1));
+    CHECK(other.materials()[0].shininess == 0);
+
+    CHECK(other.geometries().size() == 1);
+
+    if(CHECK(other.geometries()[0].polylistCollection.size() == 2)){
+
+      const ColladaLoader::Polylist& separate = other.geometries()[0].polylistCollection[0];
+      const ColladaLoader::Polylist& shared = other.geometries()[0].polylistCollection[1];
+
+      // three offsets for three inputs, then two: the texture
+      // coordinate shares the normal's
+      CHECK(separate.vertexCollection.size() == 6);
+
+      if(CHECK(shared.vertexCollection.size() == 6)){
+
+        CHECK(shared.vertexCollection[0].position == glm::vec3(0, 0, 0));
+        CHECK(shared.vertexCollection[1].position == glm::vec3(1, 1, 0));
+        CHECK(shared.vertexCollection[4].position == glm::vec3(0, 1, 0));
+
+        for(auto& vertex : shared.vertexCollection){
+
+          CHECK(vertex.normal == glm::vec3(0, 0, -1));
+          CHECK(vertex.texture == glm::vec2(1, 0));
+
+        }
+
+      }
+
+    }
+
+    CHECK(hashScene(load(loader, mesh, engine)) == meshSceneHash);
+
+  }
+
+  return testResult("test_repeated_loads");
+
+}
@@ -0,0 +1,190 @@
+#include <TestUtil.h>
+
+#include <random>
+
+#include <tinyxml/tinyxmlscan.h>
+
+// the SSE2 and AVX2 scan kernels must stop exactly where the byte at a
+// time loops they replace would, from every offset of a block, and the
+// parser must build the same tree on every level
+
+namespace {
+
+  bool
+  isSpace(char _c){
+
+    return _c == ' ' || (_c >= '\t' && _c <= '\r');
+
+  }
+
+  // the kernels as tinyxmlscan.h describes them
+  const char*
+  skipSpace(const char* _p){
+
+    while(isSpace(*_p))
+      _p++;
+
+    return _p;
+
+  }
+
+  const char*
+  scanText(const char* _p, char _stop, char _stopAlt, bool _condense){
+
+    for(const char* q = _p; ; q++){
+
+      unsigned char c = *q;
+
+      if(c == 0 || c == '&' || c == _stop || c == _stopAlt || c >= 0x80)
+        return q;
+
+      if(_condense && ((c >= '\t' && c <= '\r') || (c == ' ' && q > _p && q[-1] == ' ')))
+        return q;
+
+    }
+
+  }
+
+  const char*
+  scanColumns(const char* _p, const char* _end){
+
+    for(const char* q = _p; q < _end; q++){
+
+      unsigned char c = *q;
+
+      if(c == 0 || c == '\t' || c == '\n' || c == '\r' || c >= 0x80)
+        return q;
+
+    }
+
+    return _end;
+
+  }
+
+  // runs of the bytes the kernels stop at, between ordinary text
+  string
+  randomBytes(mt19937& _random, size_t _length){
+
+    const char bytes[] = {'a', 'b', ' ', ' ', ' ', '\t', '\n', '\r', '\v',
+                          '\f', '&', '<', '"', '\'', '\x80', '\xc3', '\xff'};
+
+    string text;
+
+    while(text.size() < _length){
+
+      char c = _random() % 3 ? 'x' : bytes[_random() % sizeof(bytes)];
+      text.append(1 + _random() % 40, c);
+
+    }
+
+    text.resize(_length);
+
+    return text;
+
+  }
+
+  int
+  compareKernels(mt19937& _random){
+
+    int failures = 0;
+
+    for(int round = 0; round < 300; round++){
+
+      // the text ends with its null at every offset of a 64 byte
+      // block, and is scanned from every position
+      size_t length = _random() % 300;
+      string text = randomBytes(_random, length);
+
+      vector<char> buffer(length + 128);
+      char* start = buffer.data() + (64 - uintptr_t(buffer.data()) % 64) % 64 +
+          _random() % 64;
+      memcpy(start, text.c_str(), length + 1);
+
+      for(size_t at = 0; at <= length; at++){
+
+        const char* p = start + at;
+        const char* end = start + at + _random() % (length - at + 1);
+
+        for(char stop : {'<', '"', '\''}){
+
+          for(bool condense : {false, true}){
+
+            if(TiXmlScanText(p, stop, stop == '<' ? '<' : '>', condense) !=
+               scanText(p, stop, stop == '<' ? '<' : '>', condense))
+              failures++;
+
+          }
+
+        }
+
+        if(TiXmlSkipSpace(p) != skipSpace(p))
+          failures++;
+
+        if(TiXmlScanColumns(p, end) != scanColumns(p, end))
+          failures++;
+
+      }
+
+    }
+
+    return failures;
+
+  }
+
+  string
+  describe(const string& _text){
+
+    TiXmlDocument doc;
+    doc.Parse(_text.c_str());
+
+    TiXmlPrinter printer;
+    doc.Accept(&printer);
+
+    return to_string(doc.ErrorId()) + " " + to_string(doc.ErrorRow()) + "," +
+        to_string(doc.ErrorCol()) + "\n" + printer.Str();
+
+  }
+
+}
+
+int
+main(){
+
+  mt19937 random(8);
+
+  TiXmlScanLevel best = TiXmlGetScanLevel();
+
+  string mesh = readFile(testData("mesh.dae"));
+  string spaced = "<r>\n\t <a  b = ' x\t y ' >  some\t\ttext  \r\n more</a>"
+      "\xc3\xa9 \t<b/>   </r>";
+  string broken = "<r>\n  <a>text & more</a>\n\t<b x='\xc3\xa9'>";
+
+  vector<string> expected;
+
+  for(const string* text : {&mesh, &spaced, &broken})
+    expected.push_back(describe(*text));
+
+  for(TiXmlScanLevel level : {TIXML_SCAN_SCALAR, TIXML_SCAN_SSE2, TIXML_SCAN_AVX2}){
+
+    if(level > best)
+      break;
+
+    TiXmlSetScanLevel(level);
+
+    if(!CHECK(TiXmlGetScanLevel() == level))
+      continue;
+
+    if(!CHECK(compareKernels(random) == 0))
+      printf("  at level %d\n", int(level));
+
+    CHECK(describe(mesh) == expected[0]);
+    CHECK(describe(spaced) == expected[1]);
+    CHECK(describe(broken) == expected[2]);
+
+  }
+
+  TiXmlSetScanLevel(best);
+
+  return testResult("test_scan");
+
+}
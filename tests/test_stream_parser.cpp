@@ -0,0 +1,159 @@
+#include <TestUtil.h>
+
+#include <XMLStreamParser.h>
+
+// the streaming parser must report the same events however its input is
+// split, skip what it is asked to skip, and reject malformed input
+
+namespace {
+
+  // every event as text, to compare runs with each other
+  class Recorder : public XMLStreamHandler {
+
+    public:
+
+      string events;
+      string skip;
+
+      void
+      startElement(const string& _name,
+                   const XMLStreamAttributes& _attributes) override {
+
+        events += "<" + _name;
+
+        for(size_t i = 0; i < _attributes.size(); i++)
+          events += " " + _attributes.name(i) + "=" + _attributes.value(i);
+
+        events += ">";
+
+      }
+
+      void
+      text(const char* _text, size_t _length) override {
+
+        events += "[" + string(_text, _length) + "]";
+
+      }
+
+      void
+      endElement(const string& _name) override {
+
+        events += "</" + _name + ">";
+
+      }
+
+      bool
+      skipElement(const string& _name, size_t _depth) override {
+
+        return _name == skip;
+
+      }
+
+  };
+
+  // _text fed in pieces of _piece bytes, or of random sizes when
+  // _piece is 0
+  string
+  parse(const string& _text, size_t _piece, const string& _skip = "",
+        size_t* _skipped = nullptr){
+
+    Recorder recorder;
+    recorder.skip = _skip;
+
+    XMLStreamParser parser(recorder, "test");
+
+    srand(2);
+
+    for(size_t at = 0; at < _text.size();){
+
+      size_t length = min(_text.size() - at,
+          _piece ? _piece : 1 + size_t(rand()) % 16);
+
+      parser.feed(_text.data() + at, length);
+      at += length;
+
+    }
+
+    parser.finish();
+
+    CHECK(parser.bytesRead() == _text.size());
+
+    if(_skipped)
+      *_skipped = parser.bytesSkipped();
+
+    return recorder.events;
+
+  }
+
+  bool
+  fails(const string& _text){
+
+    try{
+
+      parse(_text, 0);
+
+    } catch(ParseException&){
+
+      return true;
+
+    }
+
+    return false;
+
+  }
+
+}
+
+int
+main(){
+
+  string skipped = "<b x='1'><c>inner</c><b/></b>";
+
+  string document =
+      "<?xml version=\"1.0\"?>\n"
+      "<!-- a comment -->\n"
+      "<r a=\"1\" b='&lt;2&gt;'>\n"
+      "  <e>one &amp; two</e>\n"
+      "  <e/>\n"
+      "  <f><![CDATA[ <raw> & ]]>&#65;&#x42;</f>\n"
+      "  " + skipped + "\n"
+      "</r>\n";
+
+  string expected =
+      "<r a=1 b=<2>><e>[one & two]</e><e></e>"
+      "<f>[ <raw> & ][AB]</f>"
+      "<b x=1><c>[inner]</c><b></b></b></r>";
+
+  string whole = parse(document, document.size());
+
+  CHECK(whole == expected);
+
+  if(whole != expected)
+    printf("  events: %s\n", whole.c_str());
+
+  // split at every byte, and anywhere
+  CHECK(parse(document, 1) == whole);
+  CHECK(parse(document, 3) == whole);
+  CHECK(parse(document, 0) == whole);
+
+  // a skipped element is passed over, nested elements of the same
+  // name included, and what is in it isn't checked
+  size_t bytesSkipped;
+  string withoutB = "<r a=1 b=<2>><e>[one & two]</e><e></e>"
+      "<f>[ <raw> & ][AB]</f></r>";
+
+  CHECK(parse(document, 1, "b", &bytesSkipped) == withoutB);
+  CHECK(bytesSkipped == skipped.size());
+  CHECK(parse(document, 0, "b", &bytesSkipped) == withoutB);
+  CHECK(bytesSkipped == skipped.size());
+  CHECK(parse("<r><b><c x=1>&bogus;</c></b><d/></r>", 1, "b") == "<r><d></d></r>");
+
+  CHECK(fails("<r><e></f></r>"));
+  CHECK(fails("<r><e></e>"));
+  CHECK(fails(""));
+  CHECK(fails("<r a=1/>"));
+  CHECK(fails("<r/><s/>"));
+
+  return testResult("test_stream_parser");
+
+}
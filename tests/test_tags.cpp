@@ -0,0 +1,113 @@
+#include <TestUtil.h>
+
+#include <set>
+
+#include <ColladaTags.h>
+
+// every name of the COLLADA vocabulary maps to its own tag and back,
+// anything else to Unknown, and the parser stores the tags on the
+// elements as it reads them
+
+namespace {
+
+  int
+  intern(const char* _name, size_t _length){
+
+    return int(colladaTag(_name, _length));
+
+  }
+
+  // the elements under _node whose NameId isn't _expected(name)
+  template<typename Expected>
+    int
+    mismatches(const TiXmlNode* _node, Expected _expected){
+
+      int count = 0;
+
+      for(const TiXmlNode* child = _node->FirstChild(); child; child = child->NextSibling()){
+
+        if(!child->ToElement())
+          continue;
+
+        if(child->NameId() != _expected(child->ValueStr()))
+          count++;
+
+        count += mismatches(child, _expected);
+
+      }
+
+      return count;
+
+    }
+
+}
+
+int
+main(){
+
+  set<string> names;
+
+  for(size_t t = 0; t < size_t(ColladaTag::Unknown); t++){
+
+    ColladaTag tag = ColladaTag(t);
+    string name = colladaTagName(tag);
+
+    CHECK(!name.empty());
+    CHECK(names.insert(name).second);
+    CHECK(colladaTag(name) == tag);
+
+    // only the given length counts, not what follows
+    string longer = name + "x";
+    CHECK(colladaTag(longer.data(), name.size()) == tag);
+    CHECK(colladaTag(longer) == ColladaTag::Unknown);
+
+  }
+
+  // a name cut short is Unknown, unless it is a name of its own
+  for(const string& name : names){
+
+    string prefix = name.substr(0, name.size() - 1);
+
+    CHECK(names.count(prefix) ? colladaTagName(colladaTag(prefix)) == prefix :
+                                colladaTag(prefix) == ColladaTag::Unknown);
+
+  }
+
+  CHECK(colladaTag("") == ColladaTag::Unknown);
+  CHECK(colladaTag("collada") == ColladaTag::Unknown);
+  CHECK(colladaTag("Asset") == ColladaTag::Unknown);
+  CHECK(colladaTag("float_array ") == ColladaTag::Unknown);
+  CHECK(colladaTag("\xc3\xa9") == ColladaTag::Unknown);
+  CHECK(string(colladaTagName(ColladaTag::Unknown)).empty());
+
+  CHECK(colladaTag("COLLADA") == ColladaTag::COLLADA);
+  CHECK(colladaTag("float_array") == ColladaTag::FloatArray);
+  CHECK(colladaTag("polylist") == ColladaTag::Polylist);
+
+  string text = readFile(testData("mesh.dae"));
+
+  TiXmlDocument interned;
+  interned.SetInterner(intern);
+  interned.Parse(text.c_str());
+
+  CHECK(mismatches(&interned, [](const string& _name){
+
+    return int(colladaTag(_name));
+
+  }) == 0);
+
+  TiXmlDocument plain;
+  plain.Parse(text.c_str());
+
+  CHECK(mismatches(&plain, [](const string&){return -1;}) == 0);
+
+  // a renamed element no longer has the tag of its old name
+  TiXmlElement* root = interned.RootElement();
+  CHECK(root->NameId() == int(ColladaTag::COLLADA));
+
+  root->SetValue("renamed");
+  CHECK(root->NameId() == -1);
+
+  return testResult("test_tags");
+
+}
@@ -0,0 +1,162 @@
+#include <TestUtil.h>
+
+#include <random>
+
+#include <tinyxml/tinyxmlscan.h>
+
+// the structural index parallel text parsing starts from must list the
+// same spans at every scan level as a byte at a time walk does, and text
+// handed to the workers must be counted as such
+
+namespace {
+
+  TiXmlTextIndex
+  indexText(const char* _text, size_t _minLength){
+
+    TiXmlTextIndex index;
+    index.carriageReturn = false;
+
+    TiXmlTextSpan span = {0, 0, 0, 0, false};
+
+    for(size_t i = 0; ; i++){
+
+      unsigned char c = _text[i];
+
+      if(c == '<' || c == 0){
+
+        span.end = i;
+
+        if(span.end - span.start >= _minLength)
+          index.spans.push_back(span);
+
+        if(c == 0)
+          return index;
+
+        span = TiXmlTextSpan{i + 1, 0, 0, 0, false};
+
+      } else if(c == '\n'){
+
+        span.newlines++;
+        span.lastNewline = i;
+
+      } else if(c == '\r')
+        index.carriageReturn = true;
+      else if(c == '\t' || c >= 0x80)
+        span.special = true;
+
+    }
+
+  }
+
+  // lastNewline only means something when there are newlines
+  bool
+  sameIndex(const TiXmlTextIndex& _a, const TiXmlTextIndex& _b){
+
+    if(_a.spans.size() != _b.spans.size() || _a.carriageReturn != _b.carriageReturn)
+      return false;
+
+    for(size_t i = 0; i < _a.spans.size(); i++){
+
+      const TiXmlTextSpan& a = _a.spans[i];
+      const TiXmlTextSpan& b = _b.spans[i];
+
+      if(a.start != b.start || a.end != b.end || a.newlines != b.newlines ||
+         a.special != b.special || (a.newlines && a.lastNewline != b.lastNewline))
+        return false;
+
+    }
+
+    return true;
+
+  }
+
+  string
+  randomText(mt19937& _random, size_t _length){
+
+    const char bytes[] = {'a', ' ', '<', '\n', '\r', '\t', '\xc3', '>'};
+
+    string text;
+
+    while(text.size() < _length)
+      text.append(1 + _random() % 100, _random() % 2 ? 'x' : bytes[_random() % sizeof(bytes)]);
+
+    text.resize(_length);
+
+    return text;
+
+  }
+
+}
+
+int
+main(){
+
+  mt19937 random(13);
+
+  TiXmlScanLevel best = TiXmlGetScanLevel();
+
+  for(TiXmlScanLevel level : {TIXML_SCAN_SCALAR, TIXML_SCAN_SSE2, TIXML_SCAN_AVX2}){
+
+    if(level > best)
+      break;
+
+    TiXmlSetScanLevel(level);
+
+    for(int round = 0; round < 400; round++){
+
+      // starting at every offset of a 64 byte block
+      string text = randomText(random, random() % 700);
+
+      vector<char> buffer(text.size() + 128);
+      char* start = buffer.data() + (64 - uintptr_t(buffer.data()) % 64) % 64 +
+          random() % 64;
+      memcpy(start, text.c_str(), text.size() + 1);
+
+      size_t minLength = random() % 4 ? random() % 80 : 0;
+
+      TiXmlTextIndex expected = indexText(start, minLength);
+
+      TiXmlTextIndex index;
+      index.carriageReturn = false;
+      TiXmlIndexText(start, minLength, &index);
+
+      if(!CHECK(sameIndex(index, expected))){
+
+        printf("  level %d, %zu bytes, spans of %zu and up\n", int(level),
+               text.size(), minLength);
+        break;
+
+      }
+
+    }
+
+  }
+
+  TiXmlSetScanLevel(best);
+
+  // every text of at least the threshold goes to the workers, and the
+  // tree comes out as on one thread
+  string longText(5000, 'x');
+  string document = "<r><a>" + longText + "</a><b>short</b><c>" + longText +
+      "&amp;</c><d><![CDATA[" + longText + "]]></d></r>";
+
+  TiXmlDocument serial;
+  serial.Parse(document.c_str());
+
+  TiXmlDocument parallel;
+  parallel.SetParallelText(2, 1000);
+  parallel.Parse(document.c_str());
+
+  TiXmlPrinter serialPrinter, parallelPrinter;
+  serial.Accept(&serialPrinter);
+  parallel.Accept(&parallelPrinter);
+
+  CHECK(parallelPrinter.Str() == serialPrinter.Str());
+  CHECK(serial.LoadStats().parallelTextBytes == 0);
+
+  // the text of a and c; the CDATA section is markup
+  CHECK(parallel.LoadStats().parallelTextBytes == 2 * longText.size() + 5);
+
+  return testResult("test_text_index");
+
+}
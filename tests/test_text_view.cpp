@@ -0,0 +1,49 @@
+#include <TestUtil.h>
+
+// XMLNode::getText hands out the text of a node where the document keeps
+// it, the same text getString copies out
+
+int
+main(){
+
+  string filename = writeTemporary("text.xml",
+      "<r>\n"
+      "  <a>1 2 3</a>\n"
+      "  <b>  padded   text  </b>\n"
+      "  <c>&lt;&amp;&gt; &#65;</c>\n"
+      "  <d><![CDATA[ raw <text> ]]></d>\n"
+      "  <e/>\n"
+      "  <f><g>nested</g></f>\n"
+      "</r>\n");
+
+  {
+
+    XMLNode root(filename, "r");
+
+    vector<string> texts;
+
+    for(auto& child : root){
+
+      XMLTextView text = child.getText();
+      texts.push_back(string(text.begin(), text.end()));
+
+      if(text.empty())
+        continue;
+
+      CHECK(texts.back() == child.getString());
+
+      // not a copy: the view is the text node's own value
+      CHECK(text.data == child.getFirstChild()->Value());
+
+    }
+
+    CHECK(texts == vector<string>({"1 2 3", "padded text", "<&> A",
+                                   " raw <text> ", "", ""}));
+
+  }
+
+  remove(filename.c_str());
+
+  return testResult("test_text_view");
+
+}
@@ -0,0 +1,244 @@
+#include <TestUtil.h>
+
+#include <random>
+
+// whatever runs on worker threads must come out exactly as it does on
+// one: the array converters, the text the XML parser hands over, and
+// the loader's deduplication
+
+namespace {
+
+  // numbers with the odd token that isn't one, to stop at
+  string
+  randomArray(mt19937_64& _random){
+
+    string text = _random() % 2 ? " " : "";
+
+    for(int tokens = _random() % 300; tokens > 0; tokens--){
+
+      switch(_random() % 40){
+
+        case 0:
+          text += "x";
+          break;
+
+        case 1:
+          text += string(_random() % 100, '7');
+          break;
+
+        case 2:
+          text += "-1";
+          break;
+
+        default:
+          text += to_string(_random() % 100000) + (_random() % 2 ? ".5" : "");
+          break;
+
+      }
+
+      for(int delimiters = 1 + _random() % 3; delimiters > 0; delimiters--)
+        text += " \n\t\r"[_random() % 4];
+
+    }
+
+    return text;
+
+  }
+
+  void
+  compareArrays(mt19937_64& _random, int _texts){
+
+    for(int text = 0; text < _texts; text++){
+
+      string input = randomArray(_random);
+
+      const char* begin = input.data();
+      const char* end = begin + input.size();
+      size_t count;
+
+      NumberVector<float> floats(input.size());
+      const char* floatStop = parseFloatArray(begin, end, floats.data(),
+                                              floats.size(), count);
+      floats.resize(count);
+
+      NumberVector<uint32_t> indices(input.size());
+      const char* indexStop = parseIndexArray(begin, end, indices.data(),
+                                              indices.size(), count);
+      indices.resize(count);
+
+      for(unsigned threads = 2; threads <= 8; threads++){
+
+        NumberVector<float> threadedFloats;
+        const char* stop = parseFloatArray(begin, end, threadedFloats, threads);
+
+        CHECK(threadedFloats.size() == floats.size() && (floats.empty() ||
+              memcmp(threadedFloats.data(), floats.data(),
+                     floats.size() * sizeof(float)) == 0));
+        CHECK(stop == floatStop);
+
+        NumberVector<uint32_t> threadedIndices;
+        stop = parseIndexArray(begin, end, threadedIndices, threads);
+
+        CHECK(threadedIndices == indices);
+        CHECK(stop == indexStop);
+
+      }
+
+    }
+
+  }
+
+  // the tree, every node's location, the error and the counters
+  string
+  describe(const string& _document, int _threads, size_t _minLength,
+           bool _rawText){
+
+    TiXmlDocument doc;
+    doc.SetUseArena(true);
+    doc.SetRawText(_rawText);
+    doc.SetParallelText(_threads, _minLength);
+    doc.Parse(_document.c_str());
+
+    string description = to_string(doc.Error()) + " " + doc.ErrorDesc() +
+        " " + to_string(doc.ErrorRow()) + "," + to_string(doc.ErrorCol()) +
+        " " + to_string(doc.LoadStats().rawTextBytes) +
+        " " + to_string(doc.LoadStats().arenaBytes) + "\n";
+
+    TiXmlPrinter printer;
+    doc.Accept(&printer);
+    description += printer.Str();
+
+    vector<const TiXmlNode*> nodes = {&doc};
+
+    while(!nodes.empty()){
+
+      const TiXmlNode* node = nodes.back();
+      nodes.pop_back();
+
+      description += " " + to_string(node->Row()) + "," + to_string(node->Column());
+
+      for(const TiXmlNode* child = node->LastChild(); child; child = child->PreviousSibling())
+        nodes.push_back(child);
+
+    }
+
+    return description;
+
+  }
+
+  // text of every kind, well formed or not, with elements, CDATA and
+  // comments in between
+  void
+  compareText(mt19937_64& _random, int _documents){
+
+    const char* pieces[] = {
+      " ", "  ", "\t", "\n", "\r\n", "\r", "a", "bc", "1.5", "-2e3", "x y",
+      "   z", "]]", "&amp;", "&lt;", "&#65;", "&#x42;", "\xc3\xa9",
+      "\xe2\x82\xac", "&bogus;", "\xc3", "&#x4", "<e/>", "<f>",
+      "<![CDATA[ q  w ]]>", "<![CDATA[  ]]>", "<!-- c -->"
+    };
+    const size_t numPieces = sizeof(pieces) / sizeof(pieces[0]);
+
+    for(int document = 0; document < _documents; document++){
+
+      string text = "<r>";
+
+      for(int n = _random() % 60; n > 0; n--)
+        text += pieces[_random() % numPieces];
+
+      if(_random() % 4)
+        text += "</r>";
+
+      for(bool rawText : {false, true}){
+
+        string serial = describe(text, 0, 0, rawText);
+
+        for(size_t minLength : {0, 1, 7, 30}){
+
+          if(!CHECK(describe(text, 2, minLength, rawText) == serial)){
+
+            printf("  document: %s\n", text.c_str());
+            return;
+
+          }
+
+        }
+
+      }
+
+    }
+
+  }
+
+  ColladaLoader::Scene
+  load(const ColladaLoader::LoadOptions& _options){
+
+    ColladaLoader loader;
+
+    return loader.parseCollada(testData("mesh.dae"), "COLLADA", _options);
+
+  }
+
+}
+
+int
+main(){
+
+  mt19937_64 random(20);
+
+  compareArrays(random, 500);
+  compareText(random, 500);
+
+  // a document whose last text only turns out malformed after the
+  // workers are done with it is parsed again on one thread, from an
+  // empty arena
+  string late = "<r>";
+
+  for(int i = 0; i < 200; i++)
+    late += "<e>some text long enough to defer " + to_string(i) + "</e>";
+
+  late += "<e>text that ends badly &#x4</e></r>";
+
+  CHECK(describe(late, 2, 16, false) == describe(late, 0, 0, false));
+
+  // every threshold down to one byte, so everything that can be split
+  // is
+  ColladaLoader::LoadOptions serial;
+
+  ColladaLoader::LoadOptions threaded;
+  threaded.xml.textThreads = 2;
+  threaded.xml.textThreadBytes = 1;
+  threaded.arrayThreads = 3;
+  threaded.arrayThreadBytes = 1;
+
+  ColladaLoader::LoadOptions streaming = threaded;
+  streaming.streaming = true;
+
+  ColladaLoader::Scene scene = load(threaded);
+  uint64_t expected = hashScene(load(serial));
+
+  CHECK(hashScene(scene) == expected);
+  CHECK(scene.stats().parallelTextBytes > 0);
+  CHECK(scene.stats().parallelArrayBytes > 0);
+
+  scene = load(streaming);
+
+  CHECK(hashScene(scene) == expected);
+  CHECK(scene.stats().parallelArrayBytes > 0);
+
+  ColladaLoader::LoadOptions indexed;
+  indexed.indexed = true;
+
+  ColladaLoader::LoadOptions deduplicated = indexed;
+  deduplicated.arrayThreads = 3;
+  deduplicated.dedupThreadCorners = 1;
+
+  scene = load(deduplicated);
+
+  CHECK(hashScene(scene) == hashScene(load(indexed)));
+  CHECK(hashScene(scene) == expected);
+  CHECK(scene.stats().parallelDedupCorners > 0);
+
+  return testResult("test_threads");
+
+}
@@ -0,0 +1,97 @@
+#include <TestUtil.h>
+
+#include <iostream>
+#include <sstream>
+
+// turning access tracking off for a document changes nothing about what
+// is read from it; only warnAll, which has no record to go by, refuses
+
+namespace {
+
+  // everything in the document, read the way the loader reads
+  string
+  readAll(XMLNode& _node){
+
+    string read = _node.name() + "(" + _node.read("id", false, "", "id") + "," +
+        to_string(_node.readInt("count", false, -1, -1, 100, "count")) + ")";
+
+    for(auto& child : _node)
+      read += " " + readAll(child);
+
+    return read;
+
+  }
+
+  // whether warnAll throws, with what it prints to cerr thrown away
+  bool
+  warnAllThrows(XMLNode& _root){
+
+    ostringstream ignored;
+    streambuf* saved = cerr.rdbuf(ignored.rdbuf());
+
+    bool threw = false;
+
+    try{
+
+      _root.warnAll(true);
+
+    } catch(ParseException&){
+
+      threw = true;
+
+    }
+
+    cerr.rdbuf(saved);
+
+    return threw;
+
+  }
+
+}
+
+int
+main(){
+
+  string filename = writeTemporary("tracking.xml",
+      "<r id=\"root\">\n"
+      "  <a id=\"first\" count=\"3\"/>\n"
+      "  <b><c count=\"0\"/></b>\n"
+      "</r>\n");
+
+  XMLLoadOptions tracked;
+
+  XMLLoadOptions untracked;
+  untracked.tracking = false;
+
+  XMLNode trackedRoot(filename, "r", tracked);
+  XMLNode untrackedRoot(filename, "r", untracked);
+
+  string expected = "r(root,-1) a(first,3) b(,-1) c(,0)";
+
+  CHECK(readAll(trackedRoot) == expected);
+  CHECK(readAll(untrackedRoot) == expected);
+
+  // everything was read, so there is nothing to warn about
+  CHECK(!warnAllThrows(trackedRoot));
+  CHECK(warnAllThrows(untrackedRoot));
+
+  // errors are raised as before
+  bool threw = false;
+
+  try{
+
+    untrackedRoot.read("missing", true, "", "missing");
+
+  } catch(ParseException&){
+
+    threw = true;
+
+  }
+
+  CHECK(threw);
+
+  remove(filename.c_str());
+
+  return testResult("test_tracking");
+
+}